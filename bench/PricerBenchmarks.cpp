@@ -0,0 +1,403 @@
+// Micro-benchmarks du pricer, sortie au format de Google Benchmark (console ou JSON).
+// pricer_bench [--benchmark_filter=<regex>] [--benchmark_min_time=<secondes>] [--benchmark_format=console|json]
+//              [--benchmark_out=<fichier.json>]
+// - MonteCarlo/<option>/steps:<n>      : trajectoires par seconde (1 thread) et mmoire par trajectoire
+// - GeneratePath, Payoff               : gnration scalaire d'un "path" complet et payoff(vector)
+// - ClosedForm/..., ImpliedVolatility  : nanosecondes par option
+// - Pde/...                            : Crank-Nicolson, un strike ou une chelle de strikes par rsolution
+// - Pricer/batch/...                    : mode batch en formule ferme, ns et allocations par contrat (lot rutilis)
+// - PathCache/hit                      : payoff seul sur des trajectoires dj simules
+// - ScenarioGrid/...                    : grille spot x volatilit, trajectoires x cases par seconde
+// - MonteCarloModel/<modle>/...       : cot de r(t)/sigma(t), de la volatilit locale et de Heston face au modle plat
+// - ThreadScaling/threads:<t>          : courbe d'acclration de Monte Carlo
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BlackScholesModel.h"
+#include "HestonModel.h"
+#include "ImpliedVolatility.h"
+#include "Instrumentation.h"
+#include "LocalVolatilityModel.h"
+#include "MonteCarlo.h"
+#include "PathCache.h"
+#include "PdeSolver.h"
+#include "Pricer.h"
+#include "ThreadPool.h"
+#include "TradeArena.h"
+
+using namespace std;
+
+typedef vector<pair<string, double> > Counters;
+
+struct BenchmarkResult {
+    string name;
+    long long iterations;
+    double realTime; // ns par itration
+    double cpuTime;  // ns de CPU (tous threads) par itration
+    Counters counters;
+};
+
+static volatile double sink; // Empche le compilateur de supprimer les calculs mesurs
+
+// Flux en mmoire sans copie (l'entre du mode batch) et flux qui jette tout (sa sortie)
+struct MemoryBuffer : public streambuf {
+    void reset(const string& text) { char* p = const_cast<char*>(text.data()); setg(p, p, p + text.size()); }
+};
+
+struct NullBuffer : public streambuf {
+    int overflow(int c) override { return c == EOF ? 0 : c; }
+};
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(const string& filter, double minTime): filter(filter), minTime(minTime) {}
+
+    // body() est rpt jusqu' durer au moins minTime ; items = lments traits par appel (items_per_second).
+    // Les compteurs "par seconde" sont calculs ici, les autres (mmoire, acclration) sont passs tels quels.
+    BenchmarkResult* run(const string& name, const function<void()>& body, double items, const Counters& extra = Counters()) {
+        if (!regex_search(name, filter)) return nullptr;
+        body(); // chauffement : caches, pages, threads
+
+        long long iterations = 1;
+        double seconds = 0.0, cpuSeconds = 0.0;
+        while (true) {
+            clock_t cpuStart = clock();
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (long long i = 0; i < iterations; ++i) body();
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cpuSeconds = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+            if (seconds >= minTime || iterations >= 1000000000LL) break;
+            double factor = seconds > 0.0 ? 1.4 * minTime / seconds : 10.0; // Comme Google Benchmark : au plus x10
+            iterations = (long long)(iterations * min(10.0, max(factor, 2.0)));
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.realTime = 1e9 * seconds / iterations;
+        result.cpuTime = 1e9 * cpuSeconds / iterations;
+        result.counters.push_back(make_pair(string("items_per_second"), items * iterations / seconds));
+        result.counters.insert(result.counters.end(), extra.begin(), extra.end());
+        results.push_back(result);
+        return &results.back();
+    }
+
+    const vector<BenchmarkResult>& getResults() const { return results; }
+
+private:
+    regex filter;
+    double minTime;
+    vector<BenchmarkResult> results;
+};
+
+static string jsonEscape(const string& s) {
+    string out;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '"' || s[i] == '\\') out += '\\';
+        out += s[i];
+    }
+    return out;
+}
+
+static void writeJson(ostream& out, const vector<BenchmarkResult>& results, const char* executable) {
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+#ifdef NDEBUG
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+
+    out.precision(10);
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"executable\": \"" << jsonEscape(executable) << "\",\n"
+        << "    \"num_cpus\": " << ThreadPool::hardwareThreads() << ",\n"
+        << "    \"library_build_type\": \"" << buildType << "\"\n"
+        << "  },\n  \"benchmarks\": [\n";
+    for (size_t b = 0; b < results.size(); ++b) {
+        const BenchmarkResult& r = results[b];
+        out << "    {\n"
+            << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.realTime << ",\n"
+            << "      \"cpu_time\": " << r.cpuTime << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        for (size_t c = 0; c < r.counters.size(); ++c) out << ",\n      \"" << r.counters[c].first << "\": " << r.counters[c].second;
+        out << "\n    }" << (b + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static void writeConsole(ostream& out, const vector<BenchmarkResult>& results) {
+    char line[256];
+    snprintf(line, sizeof(line), "%-52s %14s %14s %12s", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+    out << line << "\n" << string(95, '-') << "\n";
+    for (size_t b = 0; b < results.size(); ++b) {
+        const BenchmarkResult& r = results[b];
+        snprintf(line, sizeof(line), "%-52s %14.0f %14.0f %12lld", r.name.c_str(), r.realTime, r.cpuTime, r.iterations);
+        out << line;
+        for (size_t c = 0; c < r.counters.size(); ++c) out << " " << r.counters[c].first << "=" << r.counters[c].second;
+        out << "\n";
+    }
+}
+
+// Maturit donnant exactement "steps" pas  252 pas par an (grille de MonteCarlo)
+static double maturityFor(int steps) {
+    return (steps + 0.5) / 252.0;
+}
+
+static const char* OPTION_TYPES[] = { "CallEuropeen", "PutEuropeen", "CallAsiatique", "PutAsiatique",
+                                      "CallDigital", "PutDigital", "CallLookback", "PutLookback" };
+
+// Mmoire de travail par trajectoire du moteur par paquets : 10 tableaux de doubles et 1 d'entiers 32 bits (PathBatch),
+// indpendante du nombre de pas
+static const double STREAMING_BYTES_PER_PATH = 10 * sizeof(double) + sizeof(uint32_t);
+
+int main(int argc, char* argv[]) {
+    string filter = ".", format = "console", outFile;
+    double minTime = 0.5;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.compare(0, 19, "--benchmark_filter=") == 0) filter = arg.substr(19);
+        else if (arg.compare(0, 21, "--benchmark_min_time=") == 0) minTime = atof(arg.c_str() + 21);
+        else if (arg.compare(0, 19, "--benchmark_format=") == 0) format = arg.substr(19);
+        else if (arg.compare(0, 16, "--benchmark_out=") == 0) outFile = arg.substr(16);
+        else {
+            cerr << "Usage : pricer_bench [--benchmark_filter=<regex>] [--benchmark_min_time=<s>]"
+                 << " [--benchmark_format=console|json] [--benchmark_out=<fichier.json>]" << endl;
+            return 2;
+        }
+    }
+
+    BenchmarkRunner runner(filter, minTime);
+    TradeArena arena; // Options des benchmarks
+    BlackScholesModel model(100.0, 0.03, 0.2);
+    const int STEPS[] = { 12, 52, 252 };
+
+    // --- Monte Carlo par type de payoff et nombre de pas (1 thread : dbit par coeur) ---
+    const int MC_PATHS = 16384;
+    MonteCarloSettings single(1, 1);
+    for (size_t t = 0; t < sizeof(OPTION_TYPES) / sizeof(OPTION_TYPES[0]); ++t)
+        for (size_t s = 0; s < sizeof(STEPS) / sizeof(STEPS[0]); ++s) {
+            const Option* option = Pricer::createOption(OPTION_TYPES[t], maturityFor(STEPS[s]), 100.0, arena);
+            ostringstream name;
+            name << "MonteCarlo/" << OPTION_TYPES[t] << "/steps:" << STEPS[s];
+            runner.run(name.str(), [&]() { sink = MonteCarlo::estimate(*option, model, MC_PATHS, single).price; },
+                       MC_PATHS, Counters(1, make_pair(string("bytes_per_path"), STREAMING_BYTES_PER_PATH)));
+        }
+
+    // --- Cot des modles plus riches que le modle plat : mme payoff, mmes trajectoires par paquets ---
+    {
+        const Option* asian = Pricer::createOption("CallAsiatique", maturityFor(252), 100.0, arena);
+        LocalVolatilityModel termStructure(100.0, TermStructure({ 0.25, 0.5, 1.0 }, { 0.02, 0.03, 0.035 }),
+                                           TermStructure({ 0.25, 0.5, 1.0 }, { 0.25, 0.2, 0.18 }));
+        vector<double> times = { 0.0, 0.5, 1.0 }, spots = { 50.0, 70.0, 85.0, 100.0, 115.0, 130.0, 160.0, 200.0 }, vols;
+        for (size_t i = 0; i < times.size(); ++i)
+            for (size_t j = 0; j < spots.size(); ++j) vols.push_back(0.2 - 0.2 * log(spots[j] / 100.0) / (1.0 + times[i])); // Skew
+        LocalVolatilityModel localVol(100.0, TermStructure(0.03), LocalVolSurface(times, spots, vols));
+        runner.run("MonteCarloModel/flat/CallAsiatique/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*asian, model, MC_PATHS, single).price; }, MC_PATHS);
+        runner.run("MonteCarloModel/termStructure/CallAsiatique/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*asian, termStructure, MC_PATHS, single).price; }, MC_PATHS);
+        runner.run("MonteCarloModel/localVol/CallAsiatique/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*asian, localVol, MC_PATHS, single).price; }, MC_PATHS);
+
+        // Heston (schma QE, deux normales par pas) ; le lookback mesure le cot sans la variable de contrle asiatique
+        HestonModel heston(100.0, 0.03, 0.04, 1.5, 0.04, 0.6, -0.7);
+        const Option* lookback = Pricer::createOption("CallLookback", maturityFor(252), 100.0, arena);
+        runner.run("MonteCarloModel/heston/CallAsiatique/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*asian, heston, MC_PATHS, single).price; }, MC_PATHS);
+        runner.run("MonteCarloModel/flat/CallLookback/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*lookback, model, MC_PATHS, single).price; }, MC_PATHS);
+        runner.run("MonteCarloModel/heston/CallLookback/steps:252",
+                   [&]() { sink = MonteCarlo::estimate(*lookback, heston, MC_PATHS, single).price; }, MC_PATHS);
+    }
+
+    // --- Trajectoire complte (vecteur) et payoff(vector) : le chemin des options non "streamables" ---
+    for (size_t s = 0; s < sizeof(STEPS) / sizeof(STEPS[0]); ++s) {
+        int steps = STEPS[s];
+        double T = maturityFor(steps);
+        RandomStream gen(1, 0);
+        vector<double> path;
+        ostringstream name;
+        name << "GeneratePath/vector/steps:" << steps;
+        runner.run(name.str(), [&]() { model.generatePath(T, steps, path, gen); sink = path.back(); },
+                   1, Counters(1, make_pair(string("bytes_per_path"), (double)(steps + 1) * sizeof(double))));
+
+        for (size_t t = 0; t < sizeof(OPTION_TYPES) / sizeof(OPTION_TYPES[0]); ++t) {
+            const Option* option = Pricer::createOption(OPTION_TYPES[t], T, 100.0, arena);
+            ostringstream payoffName;
+            payoffName << "Payoff/vector/" << OPTION_TYPES[t] << "/steps:" << steps;
+            runner.run(payoffName.str(), [&]() { sink = option->payoff(path); }, 1);
+        }
+    }
+
+    // --- Formules fermes : une chane de 2048 strikes et maturits ---
+    const int CHAIN = 2048;
+    vector<double> K(CHAIN), T(CHAIN), prices(CHAIN), delta(CHAIN), gamma(CHAIN), vega(CHAIN), vols(CHAIN);
+    unique_ptr<bool[]> isCall(new bool[CHAIN]);
+    for (int i = 0; i < CHAIN; ++i) {
+        K[i] = 60.0 + 80.0 * i / CHAIN;
+        T[i] = 0.1 + 2.0 * (i % 16) / 16.0;
+        isCall[i] = i % 2 == 0;
+    }
+    auto perOption = [&](const string& name, const function<void()>& body) { // Compteur ns_per_option en plus du dbit
+        BenchmarkResult* r = runner.run(name, body, CHAIN);
+        if (r) r->counters.push_back(make_pair(string("ns_per_option"), r->realTime / CHAIN));
+    };
+    perOption("ClosedForm/bsPrice", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.bsPrice(K[i], T[i], isCall[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/bsDelta", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.bsDelta(K[i], T[i], isCall[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/bsGamma", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.bsGamma(K[i], T[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/bsVega", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.bsVega(K[i], T[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/lookbackPrice/bgk", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.lookbackPrice(K[i], T[i], MonteCarlo::stepsFor(T[i]), isCall[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/geometricAsianPrice", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += model.geometricAsianPrice(K[i], T[i], MonteCarlo::stepsFor(T[i]), isCall[i]);
+        sink = total;
+    });
+    HestonModel heston(100.0, 0.03, 0.04, 1.5, 0.04, 0.6, -0.7);
+    perOption("ClosedForm/hestonEuropeanPrice", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += heston.europeanPrice(K[i], T[i], isCall[i]);
+        sink = total;
+    });
+    perOption("ClosedForm/bsBatch/chain:2048", [&]() {
+        model.bsBatch(K.data(), T.data(), isCall.get(), CHAIN, prices.data(), delta.data(), gamma.data(), vega.data());
+        sink = prices[CHAIN / 2];
+    });
+
+    model.bsBatch(K.data(), T.data(), isCall.get(), CHAIN, prices.data(), delta.data(), gamma.data(), vega.data());
+    perOption("ImpliedVolatility/solve", [&]() {
+        double total = 0.0;
+        for (int i = 0; i < CHAIN; ++i) total += ImpliedVolatility::solve(model, prices[i], K[i], T[i], isCall[i]);
+        sink = total;
+    });
+    perOption("ImpliedVolatility/solveBatch/quotes:2048", [&]() {
+        ImpliedVolatility::solveBatch(model, prices.data(), K.data(), T.data(), isCall.get(), CHAIN, vols.data());
+        sink = vols[CHAIN / 2];
+    });
+
+    // --- EDP (Crank-Nicolson, grille 400 x 200) : une Digitale, puis 64 strikes en une rsolution ---
+    {
+        const Option* digital = Pricer::createOption("CallDigital", 1.0, 100.0, arena);
+        runner.run("Pde/CallDigital/grid:400x200", [&]() { sink = PdeSolver::price(*digital, model).gamma; }, 1);
+        vector<double> ladder(64);
+        for (size_t k = 0; k < ladder.size(); ++k) ladder[k] = 70.0 + k;
+        BenchmarkResult* r = runner.run("Pde/ladder/CallEuropeen/strikes:64", [&]() {
+            sink = PdeSolver::priceLadder(Option::EUROPEAN_CALL, ladder, 1.0, model)[32].price;
+        }, ladder.size());
+        if (r) r->counters.push_back(make_pair(string("ns_per_option"), r->realTime / ladder.size()));
+    }
+
+    // --- Mode batch en formule ferme : lecture, valorisation et criture de chaque contrat, lot rutilis ---
+    {
+        const int TRADES = 1024;
+        ostringstream csv;
+        for (int i = 0; i < TRADES; ++i)
+            csv << "trade-" << i << ',' << (i % 2 ? "CallLookback" : "PutAsiatiqueGeometrique") << ',' << 80 + i % 40 << ",1,100,0.03,0.2\n";
+        string portfolio = csv.str();
+        MemoryBuffer input;
+        NullBuffer discard;
+        istream in(&input);
+        ostream out(&discard), errors(&discard);
+        TradeBook book;
+        long long allocations = 0, measured = 0;
+        bool warm = false;
+        BenchmarkResult* r = runner.run("Pricer/batch/closed-form/trades:1024", [&]() {
+            input.reset(portfolio);
+            in.clear();
+            long long before = Instrumentation::local().allocations;
+            Pricer::runBatch(in, out, errors, MC_PATHS, single, book);
+            if (warm) { allocations += Instrumentation::local().allocations - before; measured += TRADES; }
+            warm = true; // Le premier lot dimensionne l'arne et le tableau des contrats
+        }, TRADES);
+        if (r) {
+            r->counters.push_back(make_pair(string("ns_per_trade"), r->realTime / TRADES));
+            if (Instrumentation::allocationsCounted) r->counters.push_back(make_pair(string("allocs_per_trade"), measured ? (double)allocations / measured : 0.0));
+        }
+    }
+
+    // --- Cache de trajectoires : payoff seul sur un jeu dj simul ---
+    {
+        PathCache cache;
+        const Option* option = Pricer::createOption("CallAsiatique", maturityFor(252), 100.0, arena);
+        runner.run("PathCache/hit/CallAsiatique/steps:252", [&]() { sink = MonteCarlo::estimate(*option, model, MC_PATHS, single, cache).price; },
+                   MC_PATHS, Counters(1, make_pair(string("bytes_per_path"), 5.0 * sizeof(double))));
+    }
+
+    // --- Grille de scnarios 5 x 5 (spot x volatilit) : une simulation pour toutes les cases,  comparer 
+    //     25 fois MonteCarlo/CallLookback/steps:252 ---
+    {
+        vector<ScenarioShock> shocks;
+        for (int v = -2; v <= 2; ++v)
+            for (int s = -2; s <= 2; ++s) {
+                ScenarioShock shock = { 0.05 * s, 0.02 * v };
+                shocks.push_back(shock);
+            }
+        const Option* option = Pricer::createOption("CallLookback", maturityFor(252), 100.0, arena);
+        BenchmarkResult* r = runner.run("ScenarioGrid/CallLookback/steps:252/cells:25", [&]() {
+            sink = MonteCarlo::scenarioGrid(*option, model, shocks, MC_PATHS, single)[12].price;
+        }, (double)MC_PATHS * shocks.size());
+        if (r) r->counters.push_back(make_pair(string("ns_per_cell"), r->realTime / shocks.size()));
+    }
+
+    // --- Acclration multi-threads (Asiatique, 252 pas) ---
+    const int SCALING_PATHS = 1 << 18;
+    const Option* asian = Pricer::createOption("CallAsiatique", maturityFor(252), 100.0, arena);
+    double singleThread = 0.0;
+    for (int threads = 1; threads <= ThreadPool::hardwareThreads(); threads *= 2) {
+        MonteCarloSettings settings(1, threads);
+        ostringstream name;
+        name << "ThreadScaling/CallAsiatique/steps:252/threads:" << threads;
+        BenchmarkResult* r = runner.run(name.str(), [&]() { sink = MonteCarlo::estimate(*asian, model, SCALING_PATHS, settings).price; },
+                                              SCALING_PATHS, Counters(1, make_pair(string("threads"), (double)threads)));
+        if (!r) continue;
+        if (threads == 1) singleThread = r->realTime;
+        if (singleThread > 0.0) r->counters.push_back(make_pair(string("speedup"), singleThread / r->realTime));
+    }
+
+    if (format == "json") writeJson(cout, runner.getResults(), argv[0]);
+    else writeConsole(cout, runner.getResults());
+    if (!outFile.empty()) {
+        ofstream out(outFile.c_str());
+        if (!out) { cerr << "Impossible de creer " << outFile << endl; return 1; }
+        writeJson(out, runner.getResults(), argv[0]);
+    }
+    return 0;
+}
@@ -2,9 +2,20 @@
 
 #include <vector> // Elle permet de stocker l'historique des prix (le "path")
 #include <random>
+#include "RandomStream.h"
+#include "PathAccumulator.h"
+#include "PathBatch.h"
 
 
 class BlackScholesModel {
+public:
+    // Tirage des normales de generateBatch (options combinables)
+    enum Sampling {
+        PLAIN = 0,
+        ANTITHETIC = 1,     // La trajectoire i + size/2 utilise -Z de la trajectoire i
+        MOMENT_MATCHING = 2 // À chaque pas, les normales du paquet sont recentrées et réduites (moyenne 0, variance 1 exactes)
+    };
+
 private:
     double spot; // S0 : Prix actuel de l'actif sous-jacent
     double rate; // r  : Taux d'int�r�t sans risque
@@ -12,6 +23,8 @@ private:
 
     double normalCDF(double x) const; // Fonction de R�partition
     double normalPDF(double x) const; // Densit� de probabilit�
+    double geometricAveragePrice(double K, double T, double variance, bool isCall) const; // log G ~ N(log S0 + (r - sigma^2/2) T/2, variance)
+    double lookbackContinuous(double K, double T, bool isCall) const; // Lookback continu, strike du côté hors de la monnaie de S0
 
 public:
     BlackScholesModel(double S0, double r, double sigma); // Constructeur
@@ -30,7 +43,37 @@ public:
     double bsGamma(double K, double T) const; // C'est la d�riv�e seconde par rapport au Spot (Convexit�)
     double bsVega(double K, double T) const; // C'est la d�riv�e par rapport � la Volatilit�
 
+    // Call / Put sur la moyenne géométrique des steps + 1 prix S(i*T/steps), S0 compris : la moyenne est log-normale,
+    // d'où une formule fermée exacte (sert de variable de contrôle aux options asiatiques arithmétiques).
+    double geometricAsianPrice(double K, double T, int steps, bool isCall) const;
+    double geometricAsianPrice(double K, double T, bool isCall) const; // Moyenne géométrique continue sur [0, T] (steps -> infini)
+
+    // Lookback à strike fixe : Call max(max S - K, 0), Put max(K - min S, 0), l'extremum partant de S0.
+    // Surveillance continue : formule de Conze-Viswanathan.
+    double lookbackPrice(double K, double T, bool isCall) const;
+    // Extremum relevé aux steps + 1 dates i*T/steps, S0 compris (comme Monte Carlo) : formule continue avec la correction
+    // de Broadie-Glasserman-Kou (extremum discret ~ extremum continu * exp(-/+ beta * sigma * sqrt(T/steps)), beta = 0.5826).
+    // Approximation : écart relatif de l'ordre de 1e-3 à 252 dates par an.
+    double lookbackPrice(double K, double T, int steps, bool isCall) const;
+
+    // Chaîne d'options en une passe : n contrats (K[i], T[i], isCall[i]) -> prix et Grecs rangés dans 4 tableaux.
+    // d1, d2, N(d1), N(d2), N'(d1) et l'actualisation sont calculés une fois par contrat et partagés entre les sorties ;
+    // N(x) utilise l'approximation vectorisée de SimdMath (erreur absolue < 1e-14).
+    void bsBatch(const double* K, const double* T, const bool* isCall, int n,
+                 double* price, double* delta, double* gamma, double* vega) const;
+    void bsBatch(const double* K, const double* T, const bool* isCall, const double* vols, int n, // Idem avec une volatilité par contrat
+                 double* price, double* delta, double* gamma, double* vega) const;                 // (celle du modèle est ignorée)
+
     // G�n�ration de trajectoire du Mouvement Brownien G�om�trique pour Monte Carlo
     void generatePath(double T, int steps, std::vector<double>& path, std::mt19937& gen) const; // Ex�cute une simulation pas-�-pas de couverture dynamique (Delta Hedging) pour mesurer l erreur de r�plication (P&L) finale.
+    void generatePath(double T, int steps, std::vector<double>& path, RandomStream& gen) const; // Même trajectoire, tirée dans un flux reproductible (Monte Carlo parallèle)
+    void generatePath(double T, int steps, PathAccumulator& acc, RandomStream& gen) const; // Sans stockage : seul le résumé (dernier, somme, max, min) est mis à jour
+    void generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling = PLAIN) const; // batch.size trajectoires en parallèle (SoA, vectorisé)
+    void generateBatch(double T, int steps, PathBatch* batches, const double* vols, int nbVols, RandomStream& gen, // Mêmes tirages pour plusieurs volatilités
+                       int sampling = PLAIN) const;                                                            // (batches[k] suit vols[k])
+    // Variantes à partir d'accroissements browniens déjà tirés (quasi-Monte Carlo, pont brownien, scénarios rejoués) :
+    // increments[step * batch.size + i] pour le paquet, increments[step * stride] pour une trajectoire ; variance dt
+    void generateBatch(double T, int steps, PathBatch& batch, const double* increments) const;
+    void generatePath(double T, int steps, std::vector<double>& path, const double* increments, int stride) const;
 };
 
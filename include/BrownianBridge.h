@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+// Pont brownien sur une grille rgulire de "steps" pas de [0, T].
+// La premire normale fixe W(T), la deuxime le milieu, puis les quarts, etc. : les premires coordonnes
+// d'un point quasi-alatoire portent l'essentiel de la variance de la trajectoire, l o la suite de Sobol'
+// est la plus rgulire. Construction de Jckel (Monte Carlo Methods in Finance, 2002), valable pour tout "steps".
+class BrownianBridge {
+public:
+    BrownianBridge(int steps, double T);
+
+    int getSteps() const;
+    // z : "steps" normales N(0,1) ; dW[i * stride] reoit l'accroissement W(t_{i+1}) - W(t_i) (variance dt)
+    void build(const double* z, double* dW, int stride) const;
+
+private:
+    int steps;
+    std::vector<int> bridgeIndex, leftIndex, rightIndex;
+    std::vector<double> leftWeight, rightWeight, stdDev;
+    mutable std::vector<double> path; // W(t_1..t_steps) : tampon de travail (un pont par thread)
+};
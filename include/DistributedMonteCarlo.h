@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include "MonteCarlo.h"
+
+// Monte Carlo rparti sur plusieurs processus, sur une ou plusieurs machines (PSEUDO_RANDOM).
+// Le coordinateur dcoupe les blocs de la simulation en tranches contigus (environ 4 par worker, moins de blocs par
+// tranche si la rponse dpasserait la taille maximale d'un message) distribues  la demande : un worker qui finit
+// tt en reprend une autre. Le bloc b garde son flux alatoire (RandomStream(seed, b)),
+// quelle que soit la machine qui le simule : les sous-flux des workers sont disjoints par construction, et chaque
+// worker renvoie les statistiques de ses blocs (effectifs, moyennes et sommes des carrs des carts) que le
+// coordinateur fusionne dans l'ordre des blocs. Le rsultat est donc identique, au bit prs,  MonteCarlo::estimateMany
+// sans workers, tant que les machines ont la mme reprsentation des doubles.
+// Un worker injoignable, qui se dconnecte, qui renvoie une erreur ou qui reste muet au-del d'un dlai proportionnel 
+// la taille d'une tranche est abandonn : sa tranche en cours et celles qui restent sont simules par les autres, ou
+// localement en dernier recours. Les workers abandonns et les tranches simules localement sont signals sur std::cerr.
+//
+// Protocole (TCP, ordre des octets de l'hte, vrifi) : chaque message est un en-tte "OPMC" (version, marqueur
+// d'ordre des octets, taille) suivi de son contenu. Requte : march, maturit, graine, nombre de trajectoires, plage
+// de blocs, rglages de rduction de variance et (famille, strike) de chaque option. Rponse : un statut, puis les
+// statistiques de chaque (bloc, option) ou un message d'erreur. Une connexion sert plusieurs requtes  la suite.
+class DistributedMonteCarlo {
+public:
+    static const unsigned int PROTOCOL_VERSION = 1;
+
+    // Mme contrat que MonteCarlo::estimateMany, sur les workers de settings.workers ("hte:port") ; sans workers,
+    // c'est MonteCarlo::estimateMany.
+    // invalid_argument en QUASI_RANDOM, pour un payoff CUSTOM (il n'a pas de nom  transmettre) ou une adresse invalide.
+    static std::vector<MonteCarloResult> estimateMany(const std::vector<const Option*>& options, const BlackScholesModel& model,
+                                                      int nbSimulations, const MonteCarloSettings& settings);
+
+    // Processus worker : coute sur "port" (toutes les interfaces) et sert chaque connexion dans son propre thread,
+    // les blocs d'une requte tant rpartis sur nbThreads threads (0 = tous les coeurs). Une requte hors bornes
+    // (maturit hors de ]0, 100] ans, spot ou volatilit <= 0, valeur non finie, plage de blocs hors de la simulation ou
+    // dont la rponse dpasserait la taille maximale d'un message) reoit une erreur. Ne rend pas la main ;
+    // runtime_error si le port ne peut pas tre ouvert, ou sur un systme sans sockets POSIX.
+    static void serve(int port, int nbThreads);
+};
@@ -3,10 +3,46 @@
 // Le simulateur a besoin du modle de Black-Scholes pour deux raisons principales :
 // 1) Connatre les paramtres de march (taux r, volatilit sigma).
 // 2) Utiliser les formules mathmatiques (bsDelta, bsPrice) pour calculer la couverture.
+#include <vector>
 #include "BlackScholesModel.h"
+#include "MonteCarlo.h" // MonteCarloSettings : graine et nombre de threads
+
+class PathStore; // Trajectoires enregistres dans un fichier (PathStore.h)
+
+// Paramtres de la stratgie de couverture
+struct HedgingSettings {
+    int nbRebalances;       // Dates de rajustement sur [0, T] (50 par dfaut : couverture hebdomadaire sur un an)
+    double transactionCost; // Cot proportionnel au montant chang (0.001 = 10 pb), pay  la mise en place et  chaque rajustement
+    int nbBins;             // Nombre de classes de l'histogramme
+
+    HedgingSettings(int rebalances = 50, double cost = 0.0, int bins = 50);
+};
+
+// Distribution de l'erreur de rplication (valeur du portefeuille de couverture - payoff,  maturit)
+struct HedgingResult {
+    long long nbPaths;
+    double mean, stdDev, stdError;
+    double minimum, maximum;
+    std::vector<double> quantileLevels; // 1 %, 5 %, 25 %, 50 %, 75 %, 95 %, 99 %
+    std::vector<double> quantiles;      // Quantiles empiriques correspondants (interpolation linaire)
+    double histogramLow, binWidth;      // La classe b couvre [histogramLow + b * binWidth, histogramLow + (b + 1) * binWidth[
+    std::vector<long long> histogram;
+    double elapsedSeconds;
+};
 
 class HedgingSimulator {
 public:
-    static void run(const BlackScholesModel& initModel, double K, double T, bool isCall);
-};
+    static void run(const BlackScholesModel& initModel, double K, double T, bool isCall); // Une trajectoire, dtaille  l'cran
 
+    // P&L de couverture sur nbPaths trajectoires, rparties sur les threads par blocs de MonteCarlo::BLOCK_SIZE
+    // (flux alatoire propre  chaque bloc : mme graine => mme distribution, quel que soit le nombre de threads).
+    // Les trajectoires d'un bloc avancent par paquets (SoA) : Delta vectoris, sans allocation ni affichage dans la boucle.
+    static HedgingResult simulate(const BlackScholesModel& model, double K, double T, bool isCall, int nbPaths,
+                                  const HedgingSettings& hedging = HedgingSettings(),
+                                  const MonteCarloSettings& settings = MonteCarloSettings());
+    // Idem sur les trajectoires d'un fichier (PathStore.h), lues sur place : modle, maturit et nombre de trajectoires
+    // sont ceux du fichier. Un rajustement toutes les steps / nbRebalances dates du fichier (nbRebalances <= 0 :  chaque
+    // date) ; invalid_argument si nbRebalances ne divise pas le nombre de pas.
+    static HedgingResult simulate(const PathStore& store, double K, bool isCall, const HedgingSettings& hedging = HedgingSettings(),
+                                  int nbThreads = 0);
+};
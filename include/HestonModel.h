@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include "RandomStream.h"
+#include "PathBatch.h"
+#include "BlackScholesModel.h"
+
+// Modle  volatilit stochastique de Heston :
+//   dS = r S dt + sqrt(v) S dW1,   dv = kappa (theta - v) dt + xi sqrt(v) dW2,   d<W1, W2> = rho dt
+// Trajectoires par le schma QE d'Andersen (2008) : v(t+dt) tir dans une loi qui a les deux premiers moments exacts
+// (quadratique a (b + Z)^2 si psi = s^2/m^2 <= 1.5, exponentielle avec masse en 0 sinon), log S intgr avec la
+// correction de martingale (E[S(t+dt) | S(t)] = S(t) exp(r dt) exactement) : des pas grossiers (quelques-uns par mois)
+// restent peu biaiss. La corrlation passe par les coefficients K0..K4 du schma : le spot ne consomme qu'une
+// normale indpendante de celle de la variance.
+// Se simule avec MonteCarlo::price / estimate / estimateMany (surcharges HestonModel) ; la variable de contrle est
+// alors l'europenne de mme strike, valorise par europeanPrice.
+class HestonModel {
+public:
+    // S0 > 0, v0 >= 0, kappa > 0, theta > 0, xi > 0, -1 <= rho <= 1 (invalid_argument sinon)
+    HestonModel(double S0, double r, double v0, double kappa, double theta, double xi, double rho);
+
+    double getSpot() const;
+    double getRate() const;
+    double getInitialVariance() const;
+
+    // Europenne en semi-analytique : formule de Lewis (une intgrale de la fonction caractristique de log S_T, forme
+    // "little trap" d'Albrecher et al., sans discontinuit de branche), quadrature de Gauss-Legendre par panneaux
+    // borne par la dcroissance de l'intgrande. Prix actualis ; put par parit.
+    double europeanPrice(double K, double T, bool isCall) const;
+
+    // Mmes contrats que les gnrateurs de BlackScholesModel ; le paquet garde la variance dans batch.variance
+    void generatePath(double T, int steps, std::vector<double>& path, RandomStream& gen) const;
+    void generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling = BlackScholesModel::PLAIN) const;
+
+private:
+    double spot;   // S0
+    double rate;   // r
+    double v0;     // Variance initiale
+    double kappa;  // Vitesse de retour  la moyenne
+    double theta;  // Variance de long terme
+    double xi;     // Volatilit de la variance
+    double rho;    // Corrlation spot / variance
+};
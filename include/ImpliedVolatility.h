@@ -0,0 +1,21 @@
+#pragma once
+
+// L'inversion repose sur les formules fermes du modle (bsPrice, bsVega et leur version par lots bsBatch).
+#include "BlackScholesModel.h"
+
+// Volatilit implicite : la volatilit sigma telle que bsPrice(sigma) = prix observ sur le march.
+// Point de dpart rationnel (Corrado-Miller, ou Manaster-Koehler loin de la monnaie), puis pas de Halley
+// protgs par un encadrement [min, max] (bissection si le pas en sort). Convergence typique en 2  4 itrations.
+// Le spot et le taux sont lus dans le modle ; sa volatilit est ignore.
+// Un prix hors des bornes de non-arbitrage (valeur intrinsque actualise, S ou K*exp(-rT)) donne NaN.
+class ImpliedVolatility {
+public:
+    static const int MAX_ITERATIONS = 50;
+
+    static double solve(const BlackScholesModel& market, double price, double K, double T, bool isCall, double tolerance = 1e-10);
+
+    // Toute une surface de cotations  la fois : chaque itration value les contrats encore actifs en un seul appel
+    //  bsBatch, puis retire ceux qui ont converg (les suivants ne travaillent que sur les contrats restants).
+    static void solveBatch(const BlackScholesModel& market, const double* prices, const double* K, const double* T,
+                           const bool* isCall, int n, double* vols, double tolerance = 1e-10);
+};
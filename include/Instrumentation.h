@@ -0,0 +1,148 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Instrumentation des moteurs de pricing : temps par phase, trajectoires, tirages alatoires, allocations (si le
+// compteur d'allocations est li) et charge de chaque thread, mesurs  chaque appel (MonteCarlo, HedgingSimulator, PathStore).
+// Compile par dfaut. Avec -DPRICER_NO_INSTRUMENTATION (CMake : -DPRICER_INSTRUMENTATION=OFF) les macros
+// PRICER_* ne gnrent plus aucun code et les profils restent vides.
+// Cot : deux lectures du compteur de cycles par pas et par paquet de trajectoires (quelques ns pour 256 trajectoires).
+
+struct PricingProfile;
+
+class Instrumentation {
+public:
+    // Phases du chemin critique ; le temps des tches qui n'est dans aucune phase est rapport  part ("autre")
+    enum Phase {
+        RANDOM,    // Tirages : Philox + Box-Muller, Sobol' + inverse de N + pont brownien
+        EVOLUTION, // Schma d'Euler log-normal (exp) et mise  jour des rsums. Trajectoires compltes : tirages compris
+        STORAGE,   // criture ou relecture de trajectoires gardes (PathCache, PathStore)
+        PAYOFF,    // valuation des payoffs (et des variables de contrle) ; couverture : rajustements et bilan
+        REDUCTION, // Statistiques par paquet et fusion des blocs
+        NB_PHASES
+    };
+
+    // Compteurs cumuls du thread courant depuis son dmarrage (lus par diffrence au dbut et  la fin d'un appel)
+    struct Counters {
+        long long ticks[NB_PHASES];
+        long long paths;       // Trajectoires values
+        long long draws;       // Nombres alatoires consomms (une normale ou une coordonne de Sobol')
+        long long allocations; // Appels  operator new (0 sans compteur d'allocations, voir allocationsCounted)
+    };
+
+    static const bool ENABLED;           // false si compil avec PRICER_NO_INSTRUMENTATION
+    // Vrai si le programme lie le compteur d'allocations (AllocationCounter.cpp, objet CMake pricer_allocation_counter),
+    // qui remplace operator new ; il ne fait pas partie de pricer_lib et n'est pas li par dfaut
+    static bool allocationsCounted;
+    static const char* phaseName(Phase phase);
+
+    static Counters& local() {           // Compteurs du thread courant
+        static thread_local Counters counters = {};
+        return counters;
+    }
+
+    static long long ticks() {           // Compteur de cycles (rdtsc), ou horloge monotone en ns hors x86
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return (long long)__rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    static double secondsPerTick();      // talonn une fois contre l'horloge monotone
+
+    // Chronomtre  tours : chaque lap(phase) impute  la phase le temps coul depuis le tour prcdent
+    class PhaseTimer {
+    public:
+        PhaseTimer(): last(ticks()) {}
+        void lap(Phase phase) {
+            long long now = ticks();
+            local().ticks[phase] += now - last;
+            last = now;
+        }
+        void restart() { last = ticks(); } // Le temps coul depuis le dernier tour n'est imput  aucune phase
+    private:
+        long long last;
+    };
+
+    // Impute toute la dure de vie de l'objet  une phase
+    class ScopedPhase {
+    public:
+        explicit ScopedPhase(Phase p): phase(p) {}
+        ~ScopedPhase() { timer.lap(phase); }
+    private:
+        Phase phase;
+        PhaseTimer timer;
+    };
+
+    // Un appel de pricing mesur, du constructeur au destructeur. Seul l'appel le plus externe d'un thread est mesur
+    // (MonteCarlo::estimate qui appelle estimateMany ne donne qu'un profil).  la fin, le profil devient lastProfile()
+    // du thread appelant et est transmis  l'observateur ventuel.
+    class Call {
+    public:
+        explicit Call(const char* engine);
+        ~Call();
+        static Call* current();         // Appel en cours sur ce thread (nullptr sinon)
+        static void setCurrent(Call* call); // Threads du pool : une tche qui appelle un moteur reste dans l'appel qui l'a lance
+
+        // Utilis par ThreadPool : le travail du thread "worker" (0 = thread appelant) pendant une srie de tches
+        void addWorker(int worker, const Counters& before, const Counters& after, long long busyTicks, int nbTasks);
+    private:
+        Call(const Call&);
+        Call& operator=(const Call&);
+        struct State;
+        State* state;                   // nullptr pour un appel imbriqu
+    };
+
+    static const PricingProfile& lastProfile(); // Profil du dernier appel termin sur ce thread
+    // Observateur appel  la fin de chaque appel mesur, depuis le thread de l'appel (nullptr pour le retirer).
+    // Plusieurs appels concurrents l'appellent en parallle.
+    static void setObserver(const std::function<void(const PricingProfile&)>& observer);
+};
+
+// Travail d'un thread du pool pendant un appel
+struct ThreadProfile {
+    int tasks;          // Tches (blocs) excutes
+    long long paths;
+    double busySeconds; // Temps pass dans les tches
+};
+
+// Mesures d'un appel de pricing
+struct PricingProfile {
+    std::string engine;      // Point d'entre mesur ("MonteCarlo::estimateMany", ...)
+    double elapsedSeconds;   // Temps coul de l'appel
+    double phaseSeconds[Instrumentation::NB_PHASES]; // Cumul sur tous les threads
+    double otherSeconds;     // Temps des tches hors phases
+    long long paths, draws, allocations;
+    std::vector<ThreadProfile> threads; // Un par thread ayant excut des tches (0 = thread appelant)
+
+    PricingProfile();
+    double pathsPerSecond() const;
+    double loadImbalance() const; // Temps du thread le plus charg / temps moyen (1 = quilibre parfait)
+    std::string summary() const;  // Rsum lisible (CLI)
+};
+
+#ifndef PRICER_NO_INSTRUMENTATION
+#define PRICER_PROFILE_CALL(engine) Instrumentation::Call pricerCall_(engine)
+#define PRICER_TIMER(name) Instrumentation::PhaseTimer name
+#define PRICER_LAP(name, phase) name.lap(Instrumentation::phase)
+#define PRICER_RESTART(name) name.restart()
+#define PRICER_PHASE(phase) Instrumentation::ScopedPhase pricerPhase_(Instrumentation::phase)
+#define PRICER_COUNT(counter, n) (Instrumentation::local().counter += (n))
+#else
+#define PRICER_PROFILE_CALL(engine) ((void)0)
+#define PRICER_TIMER(name) ((void)0)
+#define PRICER_LAP(name, phase) ((void)0)
+#define PRICER_RESTART(name) ((void)0)
+#define PRICER_PHASE(phase) ((void)0)
+#define PRICER_COUNT(counter, n) ((void)0)
+#endif
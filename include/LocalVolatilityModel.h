@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "RandomStream.h"
+#include "PathBatch.h"
+#include "BlackScholesModel.h"
+
+// Courbe dterministe par morceaux (taux court r(t) ou volatilit sigma(t)) : values[i] sur ]times[i-1], times[i]]
+// (]0, times[0]] pour la premire), prolonge  plat au-del du dernier point.
+class TermStructure {
+public:
+    explicit TermStructure(double value = 0.0); // Courbe plate
+    TermStructure(const std::vector<double>& times, const std::vector<double>& values); // invalid_argument si les dates ne sont pas > 0 et croissantes
+
+    double value(double t) const;
+    double integral(double t0, double t1) const;        // Intgrale de la courbe sur [t0, t1]
+    double squaredIntegral(double t0, double t1) const; // Intgrale du carr (variance cumule d'une volatilit)
+
+private:
+    double primitive(double t, bool squared) const;
+
+    std::vector<double> times, values;
+};
+
+// Surface de volatilit locale sigma(S, t) sur une grille (times x spots), interpole linairement en (log S, t)
+// et prolonge  plat hors de la grille.
+class LocalVolSurface {
+public:
+    // vols[i * spots.size() + j] = sigma(spots[j], times[i]) ; dates >= 0 et spots > 0 strictement croissants, vols > 0
+    LocalVolSurface(const std::vector<double>& times, const std::vector<double>& spots, const std::vector<double>& vols);
+
+    double volatility(double S, double t) const;
+    double lowestSpot() const;
+    double highestSpot() const;
+
+private:
+    std::vector<double> times, logSpots, vols;
+};
+
+// Modle au-del des paramtres constants de BlackScholesModel : taux r(t) et volatilit sigma(t) (structures par
+// terme), ou volatilit locale sigma(S, t). Pour un nombre de pas et une maturit donns, les constantes de chaque pas
+// sont calcules une fois (tables gardes par le modle, partages par ses copies et par les threads) :
+// - sigma(t) : drive et diffusion exactes du pas, intgrale de r - sigma^2/2 et racine de l'intgrale de sigma^2 ;
+//   les trajectoires cotent alors autant que celles du modle plat, sans erreur de discrtisation.
+// - sigma(S, t) : schma d'Euler en log S, sigma lu au dbut du pas dans une ligne de SPOT_NODES valeurs par pas,
+//   rgulire en log S (la surface y est rchantillonne) : une interpolation = un index calcul et deux lectures
+//   contigus, sans recherche dans la grille d'origine.
+// Se simule avec MonteCarlo::estimate / estimateMany (surcharges LocalVolatilityModel).
+class LocalVolatilityModel {
+public:
+    static const int SPOT_NODES = 256;
+
+    LocalVolatilityModel(double S0, const TermStructure& rate, const TermStructure& volatility); // sigma(t)
+    LocalVolatilityModel(double S0, const TermStructure& rate, const LocalVolSurface& surface);   // sigma(S, t)
+
+    double getSpot() const;
+    bool isLocal() const;                         // true : sigma dpend du spot
+    double volatility(double S, double t) const;  // sigma(S, t) (ou sigma(t))
+    double discountFactor(double T) const;        // exp(-intgrale de r sur [0, T])
+    // Modle plat quivalent sur [0, T] : taux moyen et volatilit quadratique moyenne. Sans volatilit locale, S_T a
+    // la mme loi : ses formules fermes europennes sont exactes. invalid_argument pour une volatilit locale.
+    BlackScholesModel flatEquivalent(double T) const;
+
+    // Mmes contrats que les gnrateurs de BlackScholesModel
+    void generatePath(double T, int steps, std::vector<double>& path, RandomStream& gen) const;
+    void generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling = BlackScholesModel::PLAIN) const;
+
+private:
+    struct StepTables;
+    struct TableCache;
+    std::shared_ptr<const StepTables> tablesFor(double T, int steps) const;
+
+    double spot;
+    TermStructure rate, timeVolatility;
+    std::shared_ptr<const LocalVolSurface> surface; // nullptr : volatilit sigma(t)
+    std::shared_ptr<TableCache> cache;
+};
@@ -3,15 +3,185 @@
 // La mthode Monte Carlo a besoin de des 2 classes pour fonctionner :
 // 1. Une option (Option.h)
 // 2. Un Gnrateur de scnarios de march (BlackScholesModel.h)
+#include <string>
+#include <vector>
 #include "Option.h"
 #include "BlackScholesModel.h"
+#include "RunningStats.h"
+
+class PathCache; // Jeux de trajectoires rutiliss d'un appel  l'autre (PathCache.h)
+class PathStore; // Trajectoires enregistres dans un fichier (PathStore.h)
+class LocalVolatilityModel; // r(t), sigma(t) ou volatilit locale sigma(S, t) (LocalVolatilityModel.h)
+class HestonModel;          // Volatilit stochastique (HestonModel.h)
+
+// Paramtres d'excution d'une simulation
+struct MonteCarloSettings {
+    // Source des tirages : pseudo-alatoire (Philox) ou quasi-alatoire (Sobol' brouill + pont brownien)
+    enum Generator { PSEUDO_RANDOM, QUASI_RANDOM };
+
+    unsigned long long seed; // Graine : mme graine => mme prix, au bit prs, quel que soit le nombre de threads
+    int nbThreads;           // Nombre de threads (0 = tous les coeurs)
+    Generator generator;     // PSEUDO_RANDOM par dfaut
+    int nbReplicas;          // QUASI_RANDOM : nombre de suites brouilles indpendantes (donne l'erreur standard)
+    double confidenceLevel;  // Niveau de l'intervalle de confiance du rsultat (0.95 par dfaut)
+
+    // Rduction de variance (PSEUDO_RANDOM, options "streamables" ; combinables, toutes dsactives par dfaut)
+    bool antithetic;     // Paires de trajectoires (Z, -Z)
+    bool controlVariate; // Variable de contrle de l'option (Option::hasControlVariate), coefficient estim sur l'chantillon
+    bool momentMatching; // Normales de chaque paquet recentres et rduites  chaque pas
+
+    // Calcul rparti (DistributedMonteCarlo) : processus "pricer --worker PORT" joignables, "hte:port".
+    // Vide par dfaut (tout est simul ici). Utilis par estimate / estimateMany / price sans cache, en PSEUDO_RANDOM.
+    std::vector<std::string> workers;
+
+    MonteCarloSettings(); // Graine alatoire (random_device), tous les coeurs
+    MonteCarloSettings(unsigned long long s, int threads = 0);
+};
+
+// Prix avec son erreur standard
+struct MonteCarloResult {
+    double price;
+    double stdError;   // Pseudo-alatoire : sur les units indpendantes (trajectoire, paire antithtique ou paquet) ;
+                       // quasi-alatoire : sur les moyennes des rplications
+    long long nbPaths; // Trajectoires rellement simules (arrondi au multiple du nombre de rplications en QMC, pair en antithtique)
+    // Facteur de rduction de variance : variance d'un payoff simple / (nbPaths * variance de l'estimateur).
+    // Nombre de trajectoires simples qu'il faudrait pour la mme erreur, par trajectoire simule (1 sans rduction).
+    double varianceReduction;
+    double halfWidth;                     // Demi-largeur de l'intervalle de confiance : quantile normal * stdError
+    double confidenceLow, confidenceHigh; // price -/+ halfWidth, au niveau settings.confidenceLevel
+    bool converged;                       // estimateToTolerance : tolrance atteinte dans le budget (estimate : toujours true)
+    double elapsedSeconds;
+};
+
+// Prix et Grecs issus d'une mme simulation, avec leurs erreurs standards
+struct GreeksResult {
+    double price, delta, gamma, vega;
+    double priceStdError, deltaStdError, gammaStdError, vegaStdError;
+};
+
+// Case d'une grille de scnarios de risque : spot S0 * (1 + spotShock) (choc relatif), volatilit sigma + volShock (absolu)
+struct ScenarioShock {
+    double spotShock;
+    double volShock;
+};
+
+// Prix et Grecs de spot dans une case, avec leurs erreurs standards
+struct ScenarioResult {
+    double spot, volatility;  // March choqu
+    double price, delta, gamma;
+    double priceStdError, deltaStdError, gammaStdError;
+};
+
+// Statistiques de l'estimateur sur des units indpendantes : une trajectoire, une paire antithtique, ou tout
+// un paquet avec le moment matching (ses trajectoires dpendent alors les unes des autres)
+struct EstimatorStats {
+    RunningStats paths;            // Payoffs individuels : variance d'une trajectoire simple (pour le VRF)
+    RunningStats payoff, control;  // Moyennes par unit
+    double coM2;                   // Somme des produits des carts payoff / contrle (covariance)
+
+    EstimatorStats(): coM2(0.0) {}
+
+    void addUnit(double y, double c) {
+        double dy = y - payoff.mean;
+        payoff.add(y);
+        control.add(c);
+        coM2 += dy * (c - control.mean);
+    }
+
+    void merge(const EstimatorStats& other) {
+        if (other.payoff.count > 0 && payoff.count > 0) {
+            double n = (double)payoff.count + other.payoff.count;
+            coM2 += other.coM2 + (other.payoff.mean - payoff.mean) * (other.control.mean - control.mean) * payoff.count * other.payoff.count / n;
+        } else if (payoff.count == 0) {
+            coM2 = other.coM2;
+        }
+        paths.merge(other.paths);
+        payoff.merge(other.payoff);
+        control.merge(other.control);
+    }
+};
 
 class MonteCarlo {
 public:
+    // Les trajectoires sont regroupes en blocs de BLOCK_SIZE ; le bloc b utilise le flux alatoire numro b.
+    // Le dcoupage ne dpend pas du nombre de threads, ce qui rend le rsultat reproductible.
+    static const int BLOCK_SIZE = 1024;
+    static int stepsFor(double T); // Pas de temps des trajectoires simules pour la maturit T : 252 par an (au moins 1)
+
     static double price(const Option& option, const BlackScholesModel& model, int nbSimulations); //Calcule le juste prix de l'option aujourd'hui en faisant la moyenne actualise des gains
+    static double price(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings); // Idem, avec graine et nombre de threads imposs
+    // Prix et erreur standard. En QUASI_RANDOM, chaque rplication parcourt les mmes points de la suite (brouills
+    // diffremment) par blocs de BLOCK_SIZE ; une trajectoire consomme un point de dimension "nombre de pas".
+    static MonteCarloResult estimate(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings);
+    // Plusieurs payoffs de mme maturit sur les mmes trajectoires : une seule simulation pour tout le groupe
+    // (si toutes sont "streamables", le rsultat k est identique, au bit prs,  estimate(*options[k], ...) avec les mmes rglages)
+    static std::vector<MonteCarloResult> estimateMany(const std::vector<const Option*>& options, const BlackScholesModel& model,
+                                                      int nbSimulations, const MonteCarloSettings& settings);
+    // Idem en passant par un cache : les trajectoires ne sont simules qu'au premier appel pour un mme (modle, T, pas,
+    // nbSimulations, graine, gnrateur), puis relues par tous les payoffs suivants. Rsultats identiques, au bit prs,
+    //  ceux sans cache. Options non "streamables" : simules  chaque fois, sans passer par le cache.
+    static MonteCarloResult estimate(const Option& option, const BlackScholesModel& model, int nbSimulations,
+                                     const MonteCarloSettings& settings, PathCache& cache);
+    static std::vector<MonteCarloResult> estimateMany(const std::vector<const Option*>& options, const BlackScholesModel& model,
+                                                      int nbSimulations, const MonteCarloSettings& settings, PathCache& cache);
+    // estimate / estimateMany pour un modle  structures par terme ou  volatilit locale : PSEUDO_RANDOM seulement (invalid_argument
+    // sinon), antithtique et moment matching possibles ; controlVariate et workers sont ignors. Mme dcoupage en
+    // blocs et mme reproductibilit que pour BlackScholesModel.
+    static MonteCarloResult estimate(const Option& option, const LocalVolatilityModel& model, int nbSimulations, const MonteCarloSettings& settings);
+    static std::vector<MonteCarloResult> estimateMany(const std::vector<const Option*>& options, const LocalVolatilityModel& model,
+                                                      int nbSimulations, const MonteCarloSettings& settings);
+    // Idem sous volatilit stochastique (Heston, schma QE) : PSEUDO_RANDOM seulement (invalid_argument sinon),
+    // antithtique et moment matching possibles, workers ignor. La variable de contrle (controlVariate) est
+    // l'europenne de mme strike et de mme sens, valorise par HestonModel::europeanPrice (options non europennes).
+    static double price(const Option& option, const HestonModel& model, int nbSimulations);
+    static double price(const Option& option, const HestonModel& model, int nbSimulations, const MonteCarloSettings& settings);
+    static MonteCarloResult estimate(const Option& option, const HestonModel& model, int nbSimulations, const MonteCarloSettings& settings);
+    static std::vector<MonteCarloResult> estimateMany(const std::vector<const Option*>& options, const HestonModel& model,
+                                                      int nbSimulations, const MonteCarloSettings& settings);
+    // Mode tolrance : simule par vagues jusqu' ce que halfWidth <= tolerance, ou que le budget (maxSeconds, maxSimulations)
+    // soit puis (converged = false). Chaque vague est dimensionne par la variance observe, N * (halfWidth / tolerance)^2,
+    // sans plus que doubler. En PSEUDO_RANDOM, les vagues prolongent la mme suite de blocs : le rsultat est celui
+    // de estimate avec le nombre final de trajectoires, au bit prs. En QUASI_RANDOM, chaque vague recalcule tout.
+    static MonteCarloResult estimateToTolerance(const Option& option, const BlackScholesModel& model, double tolerance,
+                                                const MonteCarloSettings& settings, double maxSeconds = 10.0,
+                                                int maxSimulations = 100000000);
+    // Trajectoires rejoues depuis un fichier, lues sur place (sans copie pour les options "streamables").
+    // La maturit de l'option doit tre celle du fichier (invalid_argument sinon) ; le modle (actualisation, variable de
+    // contrle) et le nombre de pas sont ceux du fichier. Seuls nbThreads, controlVariate et confidenceLevel sont utiliss.
+    static double price(const Option& option, const PathStore& store, const MonteCarloSettings& settings);
+    static MonteCarloResult estimate(const Option& option, const PathStore& store, const MonteCarloSettings& settings);
     // On choque le prix du spot de epsilon
     static double delta(const Option& option, const BlackScholesModel& model, int nbSimulations, double epsilon = 0.01); //Calcule la sensibilit au prix du Spot
     static double gamma(const Option& option, const BlackScholesModel& model, int nbSimulations, double epsilon = 1.0); //Calcule la sensibilit de la courbure
     static double vega(const Option& option, const BlackScholesModel& model, int nbSimulations, double epsilon = 0.001); //Calcule la sensibilit  la volatilit.
+
+    // Prix, Delta, Gamma et Vega en une seule passe : les normales sont tires une fois et servent au scnario de base,
+    // aux chocs de spot (+/- spotShift * S0, relatif) et aux chocs de volatilit (+/- volShift, absolu).
+    static GreeksResult priceWithGreeks(const Option& option, const BlackScholesModel& model, int nbSimulations,
+                                        const MonteCarloSettings& settings = MonteCarloSettings(),
+                                        double spotShift = 0.01, double volShift = 0.01);
+
+    // Grille de scnarios (rapports de risque) : prix, Delta et Gamma dans chaque case, en une seule simulation.
+    // Les normales sont tires une fois pour toute la grille ; chaque volatilit distincte fait voluer ces mmes
+    // normales (BlackScholesModel::generateBatch  plusieurs volatilits), et un choc de spot est une homothtie des
+    // trajectoires (le modle est homogne en S0) : une case ne cote qu'une mise  l'chelle des rsums et trois
+    // payoffs (Delta et Gamma par chocs relatifs +/- spotShift). Les blocs, et toutes les cases de chaque bloc, sont
+    // rpartis sur les threads ; rsultat reproductible au bit prs, comme estimate.
+    // Options "streamables", PSEUDO_RANDOM (antithtique et moment matching possibles, sans variable de contrle) ;
+    // invalid_argument sinon, ou si un choc donne un spot ou une volatilit <= 0. Rsultat k pour shocks[k].
+    static std::vector<ScenarioResult> scenarioGrid(const Option& option, const BlackScholesModel& model,
+                                                    const std::vector<ScenarioShock>& shocks, int nbSimulations,
+                                                    const MonteCarloSettings& settings, double spotShift = 0.01);
+
+    // Briques d'un calcul PSEUDO_RANDOM dcoup par plages de blocs (DistributedMonteCarlo) :
+    // statistiques de chaque bloc de [firstBlock, lastBlock) pour chaque option (case (b - firstBlock) * nbOptions + k),
+    // simules ici (settings.workers ignor) ; puis rsultats  partir de celles de tous les blocs, fusionnes dans
+    // l'ordre des blocs : identiques, au bit prs,  estimateMany quelle que soit la machine qui a simul chaque bloc.
+    // elapsedSeconds est laiss  0.
+    static std::vector<EstimatorStats> blockStatistics(const std::vector<const Option*>& options, const BlackScholesModel& model,
+                                                       int nbSimulations, const MonteCarloSettings& settings,
+                                                       int firstBlock, int lastBlock);
+    static std::vector<MonteCarloResult> resultsFromBlocks(const std::vector<const Option*>& options, const BlackScholesModel& model,
+                                                           const MonteCarloSettings& settings, const std::vector<EstimatorStats>& blockStats);
 };
 
@@ -4,26 +4,58 @@
 #include <numeric>
 #include <algorithm>
 #include <cmath>
+#include "PathAccumulator.h"
+
+class BlackScholesModel; // Formules fermes des variables de contrle
 
 
 // Classe Abstraite
 class Option {
+public:
+    // Famille de payoff : Monte Carlo s'en sert pour choisir, une fois par appel, un noyau compil pour ce payoff
+    // (PayoffKernels.h). CUSTOM (par dfaut) : appel virtuel de payoff() pour chaque trajectoire.
+    // Les classes prdfinies ne rendent leur famille, leur payoff streaming, leur formule ferme et leur variable de
+    // contrle que si l'objet est exactement de leur type : une classe qui en drive est CUSTOM, non streamable, sans
+    // formule ferme ni contrle (son payoff(path) est appel), sauf si elle redfinit ces mthodes.
+    enum PayoffType { CUSTOM, EUROPEAN_CALL, EUROPEAN_PUT, ASIAN_CALL, ASIAN_PUT, DIGITAL_CALL, DIGITAL_PUT, LOOKBACK_CALL, LOOKBACK_PUT,
+                      GEOMETRIC_ASIAN_CALL, GEOMETRIC_ASIAN_PUT };
+
+    // Prix en formule ferme dans le modle de Black-Scholes : le front de pricing (Pricer) s'en sert  la place de
+    // Monte Carlo. EXACT : mme prix que Monte Carlo  l'infini ; CORRECTED : approximation d'une surveillance
+    // discrte par une formule continue corrige (lookbacks, Broadie-Glasserman-Kou).
+    enum ClosedForm { NO_CLOSED_FORM, EXACT, CORRECTED };
+
 protected:
     double maturity;
     double strike;
-    std::string name; // Nom pour l'affichage (ex: "Put Europen")
+    const char* name; // Nom pour l'affichage (ex: "Put Europen") : chane statique, une seule copie par classe
 
 public:
-    Option(double T, double K, std::string n); // Constructeur
+    Option(double T, double K, const char* n); // Constructeur
     virtual ~Option(); // Destructeur
 
     // Ajout de const car ces mthodes ne modifient pas l'objet et elles permettent de lire ces variables
     double getMaturity() const;
     double getStrike() const;
-    std::string getName() const;
+    const char* getName() const;
 
     virtual double payoff(const std::vector<double>& path) const = 0;// Mthode virtuelle (=0) : Force chaque type d'option  dfinir sa propre formule de payoff.
                                                                // Utilise "const vector&" pour un accs sans copie  l'historique des prix.
+
+    // Version "streaming" : le payoff est calcul  partir d'un rsum de la trajectoire (O(1) en mmoire).
+    // Par dfaut une option n'en dispose pas, et Monte Carlo se rabat sur la version "vector".
+    virtual bool isStreamable() const;
+    virtual double payoff(const PathAccumulator& acc) const;
+    virtual PayoffType payoffType() const;
+
+    // Variable de contrle pour Monte Carlo : un payoff trs corrl  celui de l'option, dont le prix est connu
+    // en formule ferme dans le modle (trajectoires  "steps" pas). Aucune par dfaut.
+    virtual bool hasControlVariate() const;
+    virtual double controlPayoff(const PathAccumulator& acc) const;
+    virtual double controlPrice(const BlackScholesModel& model, int steps) const; // Prix actualis
+
+    virtual ClosedForm closedForm() const;                                          // NO_CLOSED_FORM par dfaut
+    virtual double closedFormPrice(const BlackScholesModel& model, int steps) const; // Prix actualis, trajectoires  "steps" pas
 };
 
 // --- Options Europennes ---
@@ -34,12 +66,22 @@ class CallEuropeen : public Option {
 public:
     CallEuropeen(double T, double K);
     double payoff(const std::vector<double>& path) const override; // On utilise override pour que le compilateur vrifie qu'on remplace bien la fonction virtuelle de la classe mre.
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 class PutEuropeen : public Option {
 public:
     PutEuropeen(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 // --- Options Asiatiques ---
@@ -47,12 +89,47 @@ class CallAsiatique : public Option {
 public:
     CallAsiatique(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 class PutAsiatique : public Option {
 public:
     PutAsiatique(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
+};
+
+// Moyenne gomtrique des prix de la trajectoire (S0 compris) : log-normale, prix exact en formule ferme
+class CallAsiatiqueGeometrique : public Option {
+public:
+    CallAsiatiqueGeometrique(double T, double K);
+    double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
+};
+
+class PutAsiatiqueGeometrique : public Option {
+public:
+    PutAsiatiqueGeometrique(double T, double K);
+    double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 // --- Options Digitales ---
@@ -60,11 +137,23 @@ class CallDigital : public Option {
 public:
     CallDigital(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
 };
 class PutDigital : public Option {
 public:
     PutDigital(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 // --- Options Lookback ---
@@ -72,11 +161,27 @@ class CallLookback : public Option {
 public:
     CallLookback(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
 };
 
 class PutLookback : public Option {
 public:
     PutLookback(double T, double K);
     double payoff(const std::vector<double>& path) const override;
+    bool isStreamable() const override;
+    double payoff(const PathAccumulator& acc) const override;
+    PayoffType payoffType() const override;
+    bool hasControlVariate() const override;
+    double controlPayoff(const PathAccumulator& acc) const override;
+    double controlPrice(const BlackScholesModel& model, int steps) const override;
+    ClosedForm closedForm() const override;
+    double closedFormPrice(const BlackScholesModel& model, int steps) const override;
 };
 
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+
+// Rsum d'une trajectoire mis  jour pas  pas pendant la simulation.
+// Il contient tout ce dont ont besoin les payoffs Europens (dernier prix), Asiatiques (somme),
+// Digitaux (dernier prix) et Lookback (max / min) : on n'a plus besoin de stocker le "path".
+struct PathAccumulator {
+    double last;    // S_T : dernier prix simul
+    double sum;     // Somme des prix (S0 compris), pour la moyenne arithmtique
+    double maxSpot; // Prix maximum atteint
+    double minSpot; // Prix minimum atteint
+    double logSum;  // Somme des log-prix (S0 compris), pour la moyenne gomtrique (0 si tracksLogs est faux)
+    int count;      // Nombre de prix observs (steps + 1)
+    bool tracksLogs; // false : aucun payoff ni contrle ne lit logSum, add(S) n'appelle pas log
+
+    void start(double S0, bool withLogs = true) { // Le path commence  S0
+        last = S0; sum = S0; maxSpot = S0; minSpot = S0; count = 1;
+        tracksLogs = withLogs;
+        logSum = withLogs ? std::log(S0) : 0.0;
+    }
+
+    void add(double S) { // Nouveau prix simul
+        addPrice(S);
+        if (tracksLogs) logSum += std::log(S);
+    }
+
+    void add(double S, double logS) { // Idem, log S connu du gnrateur (somme des exposants) : pas de log par pas
+        addPrice(S);
+        if (tracksLogs) logSum += logS;
+    }
+
+    double average() const { return sum / count; }
+    double geometricAverage() const { return std::exp(logSum / count); }
+
+    void addPrice(double S) {
+        last = S;
+        sum += S;
+        if (S > maxSpot) maxSpot = S;
+        if (S < minSpot) minSpot = S;
+        ++count;
+    }
+
+    PathAccumulator scaled(double factor) const { // Mme trajectoire partie de factor * S0 (le GBM est linaire en S0)
+        PathAccumulator acc = *this;
+        acc.last *= factor; acc.sum *= factor; acc.maxSpot *= factor; acc.minSpot *= factor;
+        if (tracksLogs) acc.logSum += count * std::log(factor);
+        return acc;
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "PathAccumulator.h"
+
+class RandomStream;
+
+// Vue en lecture sur les rsums de trajectoires conscutives (SoA) : ceux d'un paquet qui vient d'tre simul,
+// ou ceux d'un jeu de trajectoires gard en mmoire (PathCache). Les payoffs s'valuent de la mme faon sur les deux.
+struct PathSummaries {
+    const double* last;
+    const double* sum;
+    const double* maxSpot;
+    const double* minSpot;
+    const double* logSum;
+    int count; // Nombre de prix observs par trajectoire (steps + 1)
+
+    PathAccumulator path(int i) const { // Rsum de la trajectoire i
+        PathAccumulator acc;
+        acc.last = last[i]; acc.sum = sum[i]; acc.maxSpot = maxSpot[i]; acc.minSpot = minSpot[i];
+        acc.logSum = logSum[i]; acc.count = count; acc.tracksLogs = true;
+        return acc;
+    }
+};
+
+// Paquet de trajectoires simules en parallle, ranges en "structure de tableaux" (SoA) :
+// la case i de chaque tableau correspond  la trajectoire i. Chaque pas de temps met  jour
+// tout le paquet d'un coup, avec des boucles que le compilateur vectorise.
+struct PathBatch {
+    static const int LANES = 256; // Taille conseille : les tableaux tiennent dans le cache L1
+
+    // Grandeurs mises  jour par le gnrateur : S_T toujours, le reste  la demande (les tableaux non suivis
+    // gardent S0). Un payoff europen n'a besoin que de LAST, un asiatique de SUM, etc.
+    enum Tracking { LAST = 0, SUM = 1, MAX_SPOT = 2, MIN_SPOT = 4, LOG_SUM = 8, ALL = 15 };
+
+    int tracking;                 // Combinaison de Tracking (ALL par dfaut)
+    int size;                     // Nombre de trajectoires (pair)
+    int count;                    // Nombre de prix observs par trajectoire (steps + 1)
+    std::vector<double> last;     // S_T
+    std::vector<double> sum;      // Somme des prix (S0 compris)
+    std::vector<double> maxSpot;  // Maximum atteint
+    std::vector<double> minSpot;  // Minimum atteint
+    std::vector<double> logLast;  // log(S_t), cumul  partir des exposants (sans appel  log)
+    std::vector<double> logSum;   // Somme des log-prix (S0 compris)
+
+    // Tampons de travail du gnrateur (rutiliss d'un pas  l'autre : aucune allocation dans la boucle)
+    std::vector<uint32_t> bits;
+    std::vector<double> normals;
+    std::vector<double> growth;
+    // Second facteur des modles  volatilit stochastique (HestonModel) : variance instantane de chaque trajectoire,
+    // et cart-type de son pas en attendant les normales du spot
+    std::vector<double> variance;
+    std::vector<double> scale;
+
+    PathBatch(int n = LANES): tracking(ALL) { resize(n); }
+
+    void resize(int n) {
+        size = n + (n & 1); // Box-Muller produit les normales par paires
+        count = 0;
+        last.resize(size); sum.resize(size); maxSpot.resize(size); minSpot.resize(size);
+        logLast.resize(size); logSum.resize(size);
+        bits.resize(size); normals.resize(size); growth.resize(size);
+        variance.resize(size); scale.resize(size);
+    }
+
+    // tapes des gnrateurs par paquets (BlackScholesModel, LocalVolatilityModel, HestonModel), dfinies dans PathBatch.cpp
+    void start(double spot, int steps);                // Toutes les trajectoires commencent  S0
+    void drawNormals(RandomStream& gen, int sampling); // Normales d'un pas dans "normals" (sampling : BlackScholesModel::Sampling)
+    void advanceLogs(const double* exponent);          // log S += exposant, et somme des log-prix si LOG_SUM est suivi
+    void advance(const double* growth);                // S *= growth, puis rsum des grandeurs suivies
+
+    PathSummaries summaries() const {
+        PathSummaries view = { last.data(), sum.data(), maxSpot.data(), minSpot.data(), logSum.data(), count };
+        return view;
+    }
+
+    PathAccumulator path(int i) const { return summaries().path(i); } // Rsum de la trajectoire i
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "PathBatch.h"
+
+// Rsums (dernier prix, somme, max, min, somme des log) d'un jeu complet de trajectoires, rangs en SoA.
+// La trajectoire i d'une simulation occupe la case i : les paquets sont lus exactement comme ils ont t simuls.
+struct PathSet {
+    int count; // Nombre de prix observs par trajectoire (steps + 1)
+    std::vector<double> last, sum, maxSpot, minSpot, logSum;
+
+    PathSet(size_t nbPaths, int count);
+
+    PathSummaries at(size_t first) const;                // Vue sur les trajectoires first, first + 1, ...
+    void store(size_t first, const PathBatch& batch, int n); // Copie les n premires trajectoires du paquet  partir de first
+    size_t bytes() const;
+};
+
+// Cache de jeux de trajectoires : la simulation ne dpend que du modle, de la maturit, du nombre de pas, du nombre
+// de trajectoires et des rglages du gnrateur (graine, QMC, antithtique, moment matching), pas du payoff.
+// Un balayage de N strikes, ou un Call et un Put sur le mme sous-jacent, ne simule donc qu'une fois
+// (MonteCarlo::estimate / estimateMany avec un PathCache).
+// viction LRU ds que la mmoire totale dpasse le plafond. Utilisable depuis plusieurs threads : un jeu vinc
+// reste valide tant qu'un appel s'en sert (shared_ptr).
+class PathCache {
+public:
+    // (S0, r, sigma, T, steps, nbSimulations, seed, gnrateur, nbReplicas, chantillonnage)
+    typedef std::tuple<double, double, double, double, int, int, unsigned long long, int, int, int> Key;
+
+    explicit PathCache(size_t maxBytes = 256u << 20); // 256 Mo par dfaut (40 octets par trajectoire)
+
+    std::shared_ptr<const PathSet> find(const Key& key); // nullptr si absent ; sinon le jeu devient le plus rcent
+    void insert(const Key& key, const std::shared_ptr<const PathSet>& paths); // Ignor si le jeu dpasse  lui seul le plafond
+    void clear();
+
+    size_t getMaxBytes() const;
+    size_t getMemoryUsage() const;
+    size_t size() const;         // Nombre de jeux en mmoire
+    long long getHits() const;
+    long long getMisses() const;
+
+private:
+    typedef std::list<std::pair<Key, std::shared_ptr<const PathSet> > > Entries; // Du plus rcent au plus ancien
+
+    size_t maxBytes;
+    size_t memoryUsage;
+    long long hits, misses;
+    Entries entries;
+    std::map<Key, Entries::iterator> index;
+    mutable std::mutex access;
+};
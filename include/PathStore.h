@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "BlackScholesModel.h"
+
+// Jeu de trajectoires compltes enregistr dans un fichier binaire, pour rejouer exactement les mmes scnarios
+// d'un jour  l'autre et d'un processus  l'autre (backtests rglementaires).
+// Format (ordre des octets de la machine) :
+// - en-tte de 64 octets : "OPPATHS1", version, paramtres du modle (S0, r, sigma), T, steps, nbPaths, graine ;
+// - puis les trajectoires, chacune sur steps + 1 doubles complts jusqu' un multiple de 64 octets (alignement cache).
+//  l'ouverture le fichier est projet en mmoire (mmap) : rien n'est lu ni copi avant qu'une trajectoire soit utilise,
+// et un fichier de plusieurs Go s'ouvre instantanment. Sans mmap (hors POSIX), le fichier est charg en mmoire.
+class PathStore {
+public:
+    static const uint32_t VERSION = 1;
+
+    // Simule nbPaths trajectoires de model avec generatePath et les crit dans file (runtime_error en cas d'chec).
+    // La trajectoire i est tire dans le flux RandomStream(seed, i / MonteCarlo::BLOCK_SIZE), comme pour Monte Carlo :
+    // mme graine => mme fichier, quel que soit le nombre de threads.
+    static void write(const std::string& file, const BlackScholesModel& model, double T, int steps, long long nbPaths,
+                      unsigned long long seed, int nbThreads = 0);
+
+    explicit PathStore(const std::string& file); // Ouvre un fichier crit par write (runtime_error s'il est invalide)
+    ~PathStore();
+
+    BlackScholesModel getModel() const;
+    double getMaturity() const;
+    int getSteps() const;
+    long long getNbPaths() const;
+    unsigned long long getSeed() const;
+
+    const double* path(long long i) const { // Les steps + 1 prix de la trajectoire i, S0 compris (lus directement dans le fichier)
+        return data + i * stride;
+    }
+
+private:
+    PathStore(const PathStore&);            // Non copiable : possde la projection du fichier
+    PathStore& operator=(const PathStore&);
+    void release();
+
+    double spot, rate, volatility, maturity;
+    int steps;
+    long long nbPaths;
+    unsigned long long seed;
+    long long stride;  // Doubles par trajectoire, complment compris
+    const double* data;
+    void* mapping;     // Dbut de la projection (ou du tampon charg en mmoire)
+    size_t mappingSize;
+};
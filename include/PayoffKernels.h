@@ -0,0 +1,111 @@
+#pragma once
+
+#include "PathBatch.h"
+
+// Payoffs des options standard, crits comme des foncteurs valus trajectoire par trajectoire sur un paquet (SoA).
+// Monte Carlo choisit le foncteur une fois par appel (Option::payoffType) et l'instancie dans une boucle sans appel
+// virtuel, que le compilateur vectorise. Mmes formules que Option::payoff(const PathAccumulator&) et controlPayoff.
+// TRACKING : grandeurs que le gnrateur doit suivre pour ce payoff (PathBatch::Tracking) ; CONTROL_TRACKING : celles
+// qui ne servent qu' la variable de contrle (suivies seulement si elle est utilise).
+
+// Vue en lecture sur le rsum du paquet
+struct BatchView {
+    const double* last;
+    const double* sum;
+    const double* maxSpot;
+    const double* minSpot;
+    const double* geometric; // Moyenne gomtrique exp(logSum / count), calcule avant l'valuation si LOG_SUM est utilis
+    double invCount;         // 1 / nombre de prix par trajectoire
+};
+
+static inline double positivePart(double x) { return x > 0.0 ? x : 0.0; }
+
+struct EuropeanCallKernel {
+    static const int TRACKING = PathBatch::LAST;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit EuropeanCallKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(v.last[i] - strike); }
+    double control(const BatchView&, int) const { return 0.0; } // Pas de variable de contrle
+};
+
+struct EuropeanPutKernel {
+    static const int TRACKING = PathBatch::LAST;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit EuropeanPutKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(strike - v.last[i]); }
+    double control(const BatchView&, int) const { return 0.0; }
+};
+
+struct AsianCallKernel {
+    static const int TRACKING = PathBatch::SUM;
+    static const int CONTROL_TRACKING = PathBatch::LOG_SUM;
+    double strike;
+    explicit AsianCallKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(v.sum[i] * v.invCount - strike); }
+    double control(const BatchView& v, int i) const { return positivePart(v.geometric[i] - strike); }
+};
+
+struct AsianPutKernel {
+    static const int TRACKING = PathBatch::SUM;
+    static const int CONTROL_TRACKING = PathBatch::LOG_SUM;
+    double strike;
+    explicit AsianPutKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(strike - v.sum[i] * v.invCount); }
+    double control(const BatchView& v, int i) const { return positivePart(strike - v.geometric[i]); }
+};
+
+struct GeometricAsianCallKernel {
+    static const int TRACKING = PathBatch::LOG_SUM;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit GeometricAsianCallKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(v.geometric[i] - strike); }
+    double control(const BatchView&, int) const { return 0.0; } // Prix connu en formule ferme : pas de contrle
+};
+
+struct GeometricAsianPutKernel {
+    static const int TRACKING = PathBatch::LOG_SUM;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit GeometricAsianPutKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(strike - v.geometric[i]); }
+    double control(const BatchView&, int) const { return 0.0; }
+};
+
+struct DigitalCallKernel {
+    static const int TRACKING = PathBatch::LAST;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit DigitalCallKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return v.last[i] > strike ? 1.0 : 0.0; }
+    double control(const BatchView& v, int i) const { return positivePart(v.last[i] - strike); } // Call Europen
+};
+
+struct DigitalPutKernel {
+    static const int TRACKING = PathBatch::LAST;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit DigitalPutKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return v.last[i] < strike ? 1.0 : 0.0; }
+    double control(const BatchView& v, int i) const { return positivePart(strike - v.last[i]); } // Put Europen
+};
+
+struct LookbackCallKernel {
+    static const int TRACKING = PathBatch::MAX_SPOT;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit LookbackCallKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(v.maxSpot[i] - strike); }
+    double control(const BatchView& v, int i) const { return positivePart(v.last[i] - strike); }
+};
+
+struct LookbackPutKernel {
+    static const int TRACKING = PathBatch::MIN_SPOT;
+    static const int CONTROL_TRACKING = 0;
+    double strike;
+    explicit LookbackPutKernel(double K): strike(K) {}
+    double payoff(const BatchView& v, int i) const { return positivePart(strike - v.minSpot[i]); }
+    double control(const BatchView& v, int i) const { return positivePart(strike - v.last[i]); }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "Option.h"
+#include "BlackScholesModel.h"
+
+// Paramtres de la grille
+struct PdeSettings {
+    int nbSpaceSteps;   // Intervalles en spot (400 par dfaut)
+    int nbTimeSteps;    // Pas de temps Crank-Nicolson (200 par dfaut)
+    int rannacherSteps; // Premiers pas ( partir de la maturit) remplacs chacun par deux demi-pas implicites (2 par dfaut)
+    double concentration; // Largeur de la zone resserre autour du strike, en carts-types sigma * sqrt(T) (0.5 par dfaut)
+    double width;         // Spot maximal : K * exp(width * sigma * sqrt(T)) au moins (6 par dfaut)
+
+    PdeSettings(int space = 400, int time = 200);
+};
+
+// Prix et Grecs lus sur la grille : Delta et Gamma sont des diffrences finies de la solution, sans bruit
+struct PdeResult {
+    double price, delta, gamma;
+    double elapsedSeconds;
+};
+
+// quation de Black-Scholes rsolue par diffrences finies (Crank-Nicolson), pour les Europennes et les Digitales.
+// - Grille non uniforme en sinh, resserre autour du strike (o le payoff est anguleux ou discontinu).
+// - Lissage de Rannacher : les premiers pas sont implicites, ce qui amortit les oscillations que Crank-Nicolson
+//   laisserait sur un payoff discontinu (Gamma des Digitales).
+// - Chaque pas rsout un systme tridiagonal (algorithme de Thomas, factoris une fois) ; tous les tableaux sont
+//   allous avant la boucle en temps.
+// Les prix sont homognes en (S, K) : V(S, K) = K * v(S / K) pour un Call ou un Put, v(S / K) pour une Digitale.
+// Une seule rsolution de v, sur une grille resserre autour de S / K = 1, donne donc toute une chelle de strikes.
+class PdeSolver {
+public:
+    // EUROPEAN_CALL, EUROPEAN_PUT, DIGITAL_CALL ou DIGITAL_PUT (invalid_argument sinon)
+    static PdeResult price(const Option& option, const BlackScholesModel& model, const PdeSettings& settings = PdeSettings());
+    // Mme payoff et mme maturit pour tous les strikes : une seule rsolution en arrire (rsultat k pour strikes[k])
+    static std::vector<PdeResult> priceLadder(Option::PayoffType type, const std::vector<double>& strikes, double T,
+                                              const BlackScholesModel& model, const PdeSettings& settings = PdeSettings());
+};
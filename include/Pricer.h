@@ -0,0 +1,69 @@
+#pragma once
+
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Option.h"
+#include "BlackScholesModel.h"
+#include "MonteCarlo.h"
+#include "TradeArena.h"
+
+// Une ligne du portefeuille : un contrat et le scnario de march dans lequel le valoriser.
+// Descripteur compact (copiable tel quel) : l'identifiant et l'option sont rangs dans l'arne du lot (TradeBook).
+struct Trade {
+    const char* id;
+    Option::PayoffType type;        // Famille de l'option (son nom CSV : Pricer::typeName)
+    const Option* option;
+    double spot, rate, volatility;
+};
+
+struct TradeResult {
+    const char* method; // "formule", "formule-corrigee" (Option::CORRECTED) ou "monte-carlo"
+    double price;
+    double stdError;    // 0 pour une formule ferme
+    long long nbPaths;
+};
+
+// Lot de contrats rutilisable : clear() garde la mmoire de l'arne et du tableau. Une fois un lot de mme taille
+// pass, lire et valoriser un contrat en formule ferme n'alloue plus rien sur le tas ; un groupe Monte Carlo
+// alloue ses tampons de simulation une fois par groupe, quel que soit son nombre de contrats.
+struct TradeBook {
+    TradeArena arena;
+    std::vector<Trade> trades;
+    std::string line, error; // Tampons de lecture de runBatch
+
+    void clear() { trades.clear(); arena.reset(); }
+};
+
+// Valorisation non interactive d'un portefeuille (mode batch de l'excutable).
+// - Formule ferme quand le contrat en a une (Option::closedForm : Europennes, Asiatiques gomtriques, Lookbacks),
+//   Monte Carlo sinon.
+// - Les contrats Monte Carlo qui partagent (S0, r, sigma, T), donc le mme nombre de pas, forment un groupe :
+//   un seul jeu de trajectoires pour tous leurs payoffs (MonteCarlo::estimateMany).
+// Format CSV : "id,type,strike,maturity,spot,rate,volatility", une ligne par contrat ;
+// lignes vides, commentaires (#) et en-tte (premier champ "id") ignors.
+class Pricer {
+public:
+    // Noms CSV des familles d'options ("CallEuropeen", "PutAsiatique", ...) : chanes statiques
+    static bool parseType(const char* name, size_t length, Option::PayoffType& type); // false si le nom est inconnu
+    static const char* typeName(Option::PayoffType type);                            // "" pour CUSTOM
+    static Option* createOption(const std::string& type, double T, double K, TradeArena& arena); // nullptr si le type est inconnu
+    // false (et error) si la ligne est invalide ; l'identifiant et l'option sont crs dans "arena"
+    static bool parseTrade(const std::string& line, TradeArena& arena, Trade& trade, std::string& error);
+
+    // Rsultats livrs au fil de l'eau : onResult(indice du contrat, rsultat), groupe par groupe
+    static void priceAll(const std::vector<Trade>& trades, int nbSimulations, const MonteCarloSettings& settings,
+                         const std::function<void(size_t, const TradeResult&)>& onResult);
+    static std::vector<TradeResult> priceAll(const std::vector<Trade>& trades, int nbSimulations, const MonteCarloSettings& settings);
+
+    // Ligne de rsultat CSV, sans fin de ligne : "id,type,strike,maturity,spot,rate,volatility,method,price,std_error,paths"
+    static void writeResult(std::ostream& out, const Trade& trade, const TradeResult& result);
+
+    // Lit le portefeuille sur "in", crit un CSV de rsultats sur "out" (une ligne par contrat, ds que son groupe est valoris).
+    // Les lignes invalides sont signales sur "errors" et ignores ; renvoie leur nombre.
+    static int runBatch(std::istream& in, std::ostream& out, std::ostream& errors, int nbSimulations, const MonteCarloSettings& settings);
+    // Idem dans un lot rutilis d'un appel  l'autre (vid au dbut)
+    static int runBatch(std::istream& in, std::ostream& out, std::ostream& errors, int nbSimulations, const MonteCarloSettings& settings,
+                        TradeBook& book);
+};
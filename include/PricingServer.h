@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include "MonteCarlo.h"
+
+// Rglages du service de valorisation
+struct PricingServerSettings {
+    std::string socketPath;         // Socket locale (AF_UNIX) ; un fichier existant  ce chemin est remplac
+    int nbWorkers;                  // Pool fixe de valorisation Monte Carlo (0 = tous les coeurs)
+    int nbSimulations;              // Trajectoires par requte Monte Carlo
+    MonteCarloSettings monteCarlo;  // Graine et rduction de variance ; nbThreads = 1 par dfaut (le paralllisme vient du pool)
+    int coalesceMicros;             // Dlai laiss aux requtes concurrentes pour rejoindre un groupe avant sa simulation
+    int maxGroupSize;               // Requtes au plus par simulation
+
+    explicit PricingServerSettings(const std::string& path = "");
+};
+
+// Mesures du service depuis son dmarrage
+struct PricingServerStats {
+    long long requests;        // Requtes valorises (formule ferme + Monte Carlo)
+    long long closedForm;      // Servies par la voie rapide, sans file d'attente
+    long long monteCarlo;
+    long long groups;          // Simulations lances pour les requtes Monte Carlo
+    long long rejected;        // Lignes invalides
+    long long failed;          // Requtes Monte Carlo en erreur (simulation du groupe interrompue par une exception)
+    double p50Ms, p99Ms;       // Latence (lecture de la ligne -> rponse envoye), sur les LATENCY_WINDOW dernires requtes
+    double requestsPerSecond;  // Dbit moyen depuis le dmarrage
+    double meanGroupSize;      // Requtes Monte Carlo par simulation
+
+    std::string summary() const; // Une ligne "cle=valeur ..."
+};
+
+// Service de valorisation longue dure sur une socket locale, pour des clients concurrents (interface de trading).
+// Protocole texte : une requte par ligne au format CSV du mode batch ("id,type,strike,maturity,spot,rate,volatility"),
+// une rponse par ligne, dans l'ordre o elles sont prtes (l'id les relie aux requtes) :
+// "id,type,...,method,price,std_error,paths,delta,gamma,vega" (Grecs des Europennes seulement, vides sinon).
+// Une ligne invalide reoit "#erreur : id : message" (id = premier champ de la ligne, comme pour un groupe en chec) ;
+// la ligne "stats" (seule sur sa ligne) reoit "#stats " + PricingServerStats::summary(). Lignes vides, commentaires
+// (#) et en-tte exact du mode batch sont ignors.
+// - Formule ferme (Option::closedForm) : calcule par le thread de lecture de la connexion, sans passer par la file.
+// - Monte Carlo : mise en file dans le groupe ouvert de mme (S0, r, sigma, T), quel que soit le client ; un worker
+//   du pool prend le plus ancien groupe, attend que coalesceMicros se soient coules depuis sa cration, le ferme et
+//   valorise tous ses payoffs sur les mmes trajectoires (MonteCarlo::estimateMany). Tant que tous les workers sont
+//   occups, les groupes en attente continuent de grossir. Le prix d'une requte ne dpend pas de son groupe
+//   (mme graine, rsultats de estimateMany identiques au bit prs  ceux d'une option seule).
+class PricingServer {
+public:
+    static const int LATENCY_WINDOW = 65536;
+
+    explicit PricingServer(const PricingServerSettings& settings);
+    ~PricingServer();
+
+    // coute et sert les connexions jusqu' stop() ; runtime_error si la socket ne peut pas tre ouverte,
+    // ou sur un systme sans sockets POSIX
+    void run();
+    void stop(); // Depuis un autre thread : run() ferme les connexions, attend les workers et rend la main
+    PricingServerStats stats() const;
+
+private:
+    PricingServer(const PricingServer&);
+    PricingServer& operator=(const PricingServer&);
+
+    struct State;
+    State* state;
+};
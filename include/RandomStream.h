@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Gnrateur alatoire "counter-based" (Philox4x32-10, Salmon et al. 2011).
+// Un flux est entirement dfini par (seed, stream) : deux flux diffrents sont indpendants,
+// et la n-ime valeur d'un flux se calcule directement  partir du compteur (pas d'tat cach).
+// C'est ce qui permet de dcouper une simulation en blocs reproductibles, quel que soit le nombre de threads.
+class RandomStream {
+public:
+    typedef uint32_t result_type; // Compatible avec les distributions de <random> (UniformRandomBitGenerator)
+
+    RandomStream(uint64_t seed, uint64_t stream); // Constructeur : la graine sert de cl, le numro de flux de compteur haut
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()() { // Tirage de 32 bits (4 valeurs par valuation de Philox)
+        if (index == 4) refill();
+        return buffer[index++];
+    }
+
+    void fill(uint32_t* out, int n); // n tirages d'un coup (mmes valeurs que n appels successifs)
+    void discard(unsigned long long n); // Saut en avant de n tirages en O(1)
+
+private:
+    uint32_t key[2];     // Cl = graine
+    uint32_t counter[4]; // counter[0..1] : position dans le flux, counter[2..3] : numro du flux
+    uint32_t buffer[4];  // Dernier bloc de 4 valeurs gnres
+    int index;           // Prochaine valeur  lire dans buffer
+
+    void refill(); // Calcule le bloc suivant et incrmente le compteur
+};
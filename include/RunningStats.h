@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cmath>
+
+// Moyenne et variance calcules au fil de l'eau (algorithme de Welford), sans stocker les valeurs.
+// Deux sries calcules sparment (par exemple deux blocs de trajectoires) se fusionnent avec merge.
+struct RunningStats {
+    long long count;
+    double mean;
+    double m2; // Somme des carrs des carts  la moyenne
+
+    RunningStats(): count(0), mean(0.0), m2(0.0) {}
+
+    void add(double x) {
+        ++count;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    void merge(const RunningStats& other) { // Formule de Chan et al.
+        if (other.count == 0) return;
+        if (count == 0) { *this = other; return; }
+        long long n = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / n;
+        m2 += other.m2 + delta * delta * ((double)count * other.count / n);
+        count = n;
+    }
+
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; } // Variance empirique (non biaise)
+    double stdError() const { return count > 0 ? std::sqrt(variance() / count) : 0.0; } // Erreur standard de la moyenne
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Multi-versionnement automatique (ifunc) des boucles de calcul : uniquement l o le chargeur le supporte
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define SIMD_CLONES
+#endif
+
+// Fonctions mathmatiques sur des tableaux, crites sans branchement pour tre vectorises.
+// Sous Linux/x86-64 (GCC, Clang), chaque fonction est compile en trois versions (AVX-512, AVX2, scalaire)
+// et la bonne est choisie au chargement du programme selon le processeur.
+// Prcision : erreur relative < 1e-15 sur les plages utilises par la simulation.
+class SimdMath {
+public:
+    static void exp(const double* x, double* y, int n); // y[i] = exp(x[i]), pour x dans [-708, 709]
+    static void log(const double* x, double* y, int n); // y[i] = log(x[i]), x > 0 et normalis
+    static void normalCdf(const double* x, double* y, int n); // y[i] = N(x[i]), erreur absolue < 1e-14 (approximation de Hart)
+    static void inverseNormalCdf(const double* u, double* z, int n); // z[i] = N^-1(u[i]), u dans [1e-100, 1 - 1e-16] (Acklam + un pas de Halley, erreur relative sur min(u, 1 - u) < 1e-8)
+
+    // Box-Muller : transforme n entiers alatoires de 32 bits en n tirages N(0,1) (n pair).
+    // Les entiers i et i + n/2 donnent les deux normales z[i] (cosinus) et z[i + n/2] (sinus).
+    static void normals(const uint32_t* bits, double* z, int n);
+};
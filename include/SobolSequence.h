@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Suite  discrpance faible de Sobol' en dimension quelconque (une dimension par pas de temps).
+// - Polynmes primitifs sur GF(2) numrs par degr croissant ; nombres directeurs initiaux de Joe & Kuo
+//   pour les premires dimensions, puis entiers impairs tirs d'un flux fixe (reproductible) au-del.
+// - Brouillage (QMC randomis) : brouillage linaire de Matousek + dcalage digital, tirs du flux (seed, replica).
+//   Chaque rplication est une suite de Sobol' valide ; leurs moyennes sont indpendantes et sans biais,
+//   ce qui donne une erreur standard malgr le caractre dterministe de la suite.
+class SobolSequence {
+public:
+    SobolSequence(int dimension, uint64_t seed, uint64_t replica, bool scrambled = true);
+
+    int getDimension() const;
+    void skipTo(uint64_t index); // Se place sur le point numro index (ordre de Gray)
+    void next(double* u);        // crit le point courant dans u[0..dimension-1] (dans ]0, 1[) puis avance
+
+private:
+    int dimension;
+    std::vector<uint32_t> directions; // 32 nombres directeurs par dimension (brouills)
+    std::vector<uint32_t> shift;      // Dcalage digital par dimension
+    std::vector<uint32_t> state;      // Point courant (avant dcalage)
+    uint64_t index;                   // Numro du point courant
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <functional>
+
+// Rpartit un ensemble de tches indpendantes (numrotes de 0  nbTasks-1) sur plusieurs threads.
+// Les threads piochent les tches dans une file commune : l'ordre d'excution est libre,
+// donc chaque tche doit crire son rsultat dans sa propre case (pas de somme partage).
+class ThreadPool {
+public:
+    static int hardwareThreads(); // Nombre de coeurs disponibles (au moins 1)
+    static void run(int nbTasks, int nbThreads, const std::function<void(int)>& task); // nbThreads <= 0 : tous les coeurs
+};
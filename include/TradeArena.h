@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Option.h"
+
+// Mmoire d'un lot de contrats : les options et les chanes (identifiants) sont ranges bout  bout dans des pages.
+// reset() dtruit les options mais garde les pages :  partir du deuxime lot de mme taille, crer une option ou
+// copier un identifiant n'alloue plus rien sur le tas (un pointeur avanc dans la page courante).
+// Les objets vivent jusqu'au reset() ou  la destruction de l'arne ; ils ne doivent pas tre librs un par un.
+class TradeArena {
+public:
+    explicit TradeArena(size_t pageSize = 64 * 1024);
+    ~TradeArena();
+
+    // Option de la famille "type" (nullptr pour CUSTOM, qui n'a pas de classe connue)
+    Option* createOption(Option::PayoffType type, double T, double K);
+    const char* copyString(const char* text, size_t length); // Copie termine par '\0'
+
+    void reset();
+    size_t bytesUsed() const;     // Occupation des pages depuis le dernier reset()
+    size_t bytesReserved() const; // Taille totale des pages gardes
+
+private:
+    TradeArena(const TradeArena&);
+    TradeArena& operator=(const TradeArena&);
+
+    struct Page {
+        char* data;
+        size_t size;
+    };
+
+    void* allocate(size_t size, size_t alignment);
+    template <class Concrete> Option* make(double T, double K);
+
+    size_t pageSize;
+    std::vector<Page> pages;
+    size_t current;              // Page en cours de remplissage
+    size_t offset;               // Premier octet libre de la page courante
+    size_t used;                 // Octets occups dans les pages dj remplies
+    std::vector<Option*> options; //  dtruire au reset() (capacit garde)
+};
@@ -0,0 +1,37 @@
+#include "Instrumentation.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// Comptage des allocations : remplace operator new / delete pour tout le programme (un incrment d'un compteur propre
+// au thread par allocation). Hors de pricer_lib, pour ne pas imposer cet allocateur aux programmes qui lient la
+// bibliothque : objet pricer_allocation_counter, li par les tests, le benchmark, et par pricer avec
+// -DPRICER_COUNT_ALLOCATIONS=ON.
+
+static const bool registered = (Instrumentation::allocationsCounted = true);
+
+void* operator new(size_t size) {
+    ++Instrumentation::local().allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    ++Instrumentation::local().allocations;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return operator new(size, nothrow);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
@@ -1,4 +1,6 @@
 #include "BlackScholesModel.h"
+#include "SimdMath.h"
+#include "Instrumentation.h"
 #include <cmath>
 #include <algorithm>
 
@@ -50,17 +52,226 @@ double BlackScholesModel::bsVega(double K, double T) const {  // Calcul du VEGA
     return spot * sqrt(T) * normalPDF(d1); // Vega = S * sqrt(T) * N'(d1)
 }
 
-void BlackScholesModel::generatePath(double T, int steps, vector<double>& path, mt19937& gen) const {
+double BlackScholesModel::geometricAsianPrice(double K, double T, int steps, bool isCall) const {
+    // log G = moyenne des log S(t_i), t_i = i*dt (i = 0..steps) : gaussien
+    // Moyenne : log S0 + (r - sigma^2/2) * T/2 ; Variance : sigma^2 * dt * n(2n+1) / (6(n+1)), n = steps
+    double dt = T / steps;
+    double variance = volatility * volatility * dt * steps * (2.0 * steps + 1.0) / (6.0 * (steps + 1.0));
+    return geometricAveragePrice(K, T, variance, isCall);
+}
+
+double BlackScholesModel::geometricAsianPrice(double K, double T, bool isCall) const {
+    return geometricAveragePrice(K, T, volatility * volatility * T / 3.0, isCall); // Variance de la moyenne continue : sigma^2 T / 3
+}
+
+double BlackScholesModel::geometricAveragePrice(double K, double T, double variance, bool isCall) const {
+    double mu = log(spot) + (rate - 0.5 * volatility * volatility) * 0.5 * T;
+    double sd = sqrt(variance);
+    double forward = exp(mu + 0.5 * variance); // E[G]
+    double d2 = (mu - log(K)) / sd;
+    double d1 = d2 + sd;
+    double discount = exp(-rate * T);
+
+    if (isCall)
+        return discount * (forward * normalCDF(d1) - K * normalCDF(d2));
+    else
+        return discount * (K * normalCDF(-d2) - forward * normalCDF(-d1));
+}
+
+// Lookback continu (Conze-Viswanathan) avec K >= S0 pour le Call, K <= S0 pour le Put (extremum initial = S0)
+double BlackScholesModel::lookbackContinuous(double K, double T, bool isCall) const {
+    double r = fabs(rate) < 1e-8 ? (rate < 0.0 ? -1e-8 : 1e-8) : rate; // La formule a une limite finie en r = 0
+    double sigmaT = volatility * sqrt(T);
+    double d1 = (log(spot / K) + (r + 0.5 * volatility * volatility) * T) / sigmaT;
+    double d2 = d1 - sigmaT;
+    double ratio = 0.5 * volatility * volatility / r;
+    double reflection = pow(spot / K, -1.0 / ratio); // (S/K)^(-2r/sigma^2)
+    double shift = 2.0 * r * sqrt(T) / volatility;
+    double discount = exp(-r * T);
+    if (isCall)
+        return spot * normalCDF(d1) - K * discount * normalCDF(d2)
+             + spot * discount * ratio * (-reflection * normalCDF(d1 - shift) + exp(r * T) * normalCDF(d1));
+    return K * discount * normalCDF(-d2) - spot * normalCDF(-d1)
+         + spot * discount * ratio * (reflection * normalCDF(-d1 + shift) - exp(r * T) * normalCDF(-d1));
+}
+
+double BlackScholesModel::lookbackPrice(double K, double T, bool isCall) const {
+    // Strike du ct dans la monnaie de S0 : la partie (S0 - K) est acquise, reste le lookback de strike S0
+    double discount = exp(-rate * T);
+    if (isCall) return discount * max(spot - K, 0.0) + lookbackContinuous(max(K, spot), T, true);
+    return discount * max(K - spot, 0.0) + lookbackContinuous(min(K, spot), T, false);
+}
+
+double BlackScholesModel::lookbackPrice(double K, double T, int steps, bool isCall) const {
+    // P(max discret > h) ~ P(max continu > h * exp(a)) pour h > S0, d'o E[(M_m - H)+] ~ exp(-a) E[(M - H exp(a))+]
+    const double BETA = 0.5825971579390106; // -zeta(1/2) / sqrt(2 pi)
+    double a = BETA * volatility * sqrt(T / steps);
+    double discount = exp(-rate * T);
+    if (isCall) return discount * max(spot - K, 0.0) + exp(-a) * lookbackContinuous(max(K, spot) * exp(a), T, true);
+    return discount * max(K - spot, 0.0) + exp(a) * lookbackContinuous(min(K, spot) * exp(-a), T, false);
+}
+
+// Combinaison finale des quantits partages en prix et Grecs. Avec w = +1 (Call) ou -1 (Put) :
+// Prix = w * (S*N(w*d1) - K*exp(-rT)*N(w*d2)) et Delta = w * N(w*d1), sans branchement ni perte de prcision pour les Puts
+SIMD_CLONES
+static void combineBatch(double spot, const double* vol, const double* K, const double* w, const double* sqrtT,
+                         const double* discount, const double* nd1, const double* nd2, const double* pdf, int n,
+                         double* __restrict price, double* __restrict delta, double* __restrict gamma, double* __restrict vega) {
+    for (int i = 0; i < n; ++i) {
+        price[i] = w[i] * (spot * nd1[i] - K[i] * discount[i] * nd2[i]);
+        delta[i] = w[i] * nd1[i];
+        gamma[i] = pdf[i] / (spot * vol[i] * sqrtT[i]);
+        vega[i] = spot * sqrtT[i] * pdf[i];
+    }
+}
+
+// d1 et d2 signs (w*d1, w*d2) et exposant de N'(d1), pour un paquet de contrats
+SIMD_CLONES
+static void d1Batch(double rate, const double* vol, const double* logMoneyness, const double* t, const double* sqrtT,
+                    const double* w, int n, double* __restrict d1, double* __restrict d2, double* __restrict pdf) {
+    for (int i = 0; i < n; ++i) {
+        double volT = vol[i] * sqrtT[i];
+        double x1 = (logMoneyness[i] + (rate + 0.5 * vol[i] * vol[i]) * t[i]) / volT;
+        d1[i] = w[i] * x1;
+        d2[i] = w[i] * (x1 - volT);
+        pdf[i] = -0.5 * x1 * x1;
+    }
+}
+
+void BlackScholesModel::bsBatch(const double* K, const double* T, const bool* isCall, int n,
+                                double* price, double* delta, double* gamma, double* vega) const {
+    bsBatch(K, T, isCall, nullptr, n, price, delta, gamma, vega);
+}
+
+void BlackScholesModel::bsBatch(const double* K, const double* T, const bool* isCall, const double* vols, int n,
+                                double* price, double* delta, double* gamma, double* vega) const {
+    const int CHUNK = 256; // Tampons intermdiaires sur la pile, dans le cache L1
+    double vol[CHUNK], logMoneyness[CHUNK], sqrtT[CHUNK], discount[CHUNK], w[CHUNK];
+    double d1[CHUNK], d2[CHUNK], nd1[CHUNK], nd2[CHUNK], pdf[CHUNK];
+
+    for (int start = 0; start < n; start += CHUNK) {
+        int m = min(CHUNK, n - start);
+        const double* k = K + start;
+        const double* t = T + start;
+        const bool* call = isCall + start;
+
+        for (int i = 0; i < m; ++i) vol[i] = vols ? vols[start + i] : volatility; // Sans tableau : volatilit du modle
+        for (int i = 0; i < m; ++i) logMoneyness[i] = spot / k[i];
+        SimdMath::log(logMoneyness, logMoneyness, m);          // log(S/K)
+        for (int i = 0; i < m; ++i) sqrtT[i] = sqrt(t[i]);
+        for (int i = 0; i < m; ++i) discount[i] = -rate * t[i];
+        SimdMath::exp(discount, discount, m);                  // exp(-r*T)
+
+        for (int i = 0; i < m; ++i) w[i] = call[i] ? 1.0 : -1.0; // w = +1 (Call) ou -1 (Put)
+        d1Batch(rate, vol, logMoneyness, t, sqrtT, w, m, d1, d2, pdf);
+        SimdMath::normalCdf(d1, nd1, m);
+        SimdMath::normalCdf(d2, nd2, m);
+        SimdMath::exp(pdf, pdf, m);
+        for (int i = 0; i < m; ++i) pdf[i] *= 1.0 / sqrt(2.0 * M_PI); // N'(d1)
+
+        combineBatch(spot, vol, k, w, sqrtT, discount, nd1, nd2, pdf, m,
+                     price + start, delta + start, gamma + start, vega + start);
+    }
+}
+
+// Adaptateur : la trajectoire complte est stocke dans le vecteur
+struct PathRecorder {
+    vector<double>& path;
+    void start(double S0) { path.clear(); path.push_back(S0); }
+    void add(double S, double) { path.push_back(S); }
+};
+
+// Le schma est le mme quel que soit le gnrateur et la faon de garder la trajectoire : on l'crit une seule fois
+template <class Generator, class Sink>
+static void simulateGBM(const BlackScholesModel& model, double T, int steps, Sink& sink, Generator& gen) {
+    PRICER_PHASE(EVOLUTION); // Tirages et exp entremls : tout est imput  l'volution
+    PRICER_COUNT(draws, steps);
     normal_distribution<> normal(0.0, 1.0); // Distribution Normale Standard N(0,1) pour gnrer le hasard
     double dt = T / steps;  // Pas de temps
-    double currentSpot = spot;
+    double rate = model.getRate();
+    double volatility = model.getVolatility();
+    double currentSpot = model.getSpot();
+    double logSpot = log(currentSpot); // Suivi par les exposants, comme PathBatch::advanceLogs : pas de log par pas
 
-    path.clear();
-    path.push_back(currentSpot); // Le path commence   S0
+    sink.start(currentSpot); // Le path commence   S0
 
     for(int i=0; i<steps; ++i) {
         double Z = normal(gen); // Tirage alatoire (Loi Normale)
-        currentSpot *= exp((rate - 0.5 * volatility * volatility) * dt + volatility * sqrt(dt) * Z); // S(t+dt)=S(t)*exp( (r - 0.5*sigma^2)*dt + sigma*sqrt(dt)*Z )
+        double exponent = (rate - 0.5 * volatility * volatility) * dt + volatility * sqrt(dt) * Z;
+        currentSpot *= exp(exponent); // S(t+dt)=S(t)*exp( (r - 0.5*sigma^2)*dt + sigma*sqrt(dt)*Z )
+        logSpot += exponent;
+        sink.add(currentSpot, logSpot);
+    }
+}
+
+void BlackScholesModel::generatePath(double T, int steps, vector<double>& path, mt19937& gen) const {
+    PathRecorder recorder = { path };
+    simulateGBM(*this, T, steps, recorder, gen);
+}
+
+void BlackScholesModel::generatePath(double T, int steps, vector<double>& path, RandomStream& gen) const {
+    PathRecorder recorder = { path };
+    simulateGBM(*this, T, steps, recorder, gen);
+}
+
+void BlackScholesModel::generatePath(double T, int steps, PathAccumulator& acc, RandomStream& gen) const {
+    simulateGBM(*this, T, steps, acc, gen);
+}
+
+void BlackScholesModel::generatePath(double T, int steps, vector<double>& path, const double* increments, int stride) const {
+    PRICER_PHASE(EVOLUTION);
+    double dt = T / steps;
+    double drift = (rate - 0.5 * volatility * volatility) * dt;
+    double currentSpot = spot;
+    path.clear();
+    path.push_back(currentSpot);
+    for (int i = 0; i < steps; ++i) {
+        currentSpot *= exp(drift + volatility * increments[i * stride]); // Accroissement brownien fourni (variance dt)
         path.push_back(currentSpot);
     }
 }
+
+void BlackScholesModel::generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling) const {
+    generateBatch(T, steps, &batch, &volatility, 1, gen, sampling);
+}
+
+void BlackScholesModel::generateBatch(double T, int steps, PathBatch& batch, const double* increments) const {
+    PRICER_PHASE(EVOLUTION);
+    int n = batch.size;
+    double drift = (rate - 0.5 * volatility * volatility) * (T / steps);
+    batch.start(spot, steps);
+
+    double* growth = batch.growth.data();
+    for (int step = 0; step < steps; ++step) {
+        const double* dW = increments + (size_t)step * n; // Accroissements du pas, rangs par trajectoire
+        for (int i = 0; i < n; ++i) growth[i] = drift + volatility * dW[i];
+        batch.advanceLogs(growth);
+        SimdMath::exp(growth, growth, n);
+        batch.advance(growth);
+    }
+}
+
+void BlackScholesModel::generateBatch(double T, int steps, PathBatch* batches, const double* vols, int nbVols, RandomStream& gen, int sampling) const {
+    int n = batches[0].size;
+    double dt = T / steps;
+
+    for (int k = 0; k < nbVols; ++k) batches[k].start(spot, steps);
+
+    double* z = batches[0].normals.data();
+    PRICER_TIMER(timer);
+    for (int step = 0; step < steps; ++step) {
+        batches[0].drawNormals(gen, sampling); // Normales communes  tous les scnarios
+        PRICER_LAP(timer, RANDOM);
+        for (int k = 0; k < nbVols; ++k) {
+            // Constantes du schma : ne dpendent que de la volatilit du scnario
+            double drift = (rate - 0.5 * vols[k] * vols[k]) * dt;
+            double diffusion = vols[k] * sqrt(dt);
+            double* growth = batches[k].growth.data();
+            for (int i = 0; i < n; ++i) growth[i] = drift + diffusion * z[i];
+            batches[k].advanceLogs(growth);
+            SimdMath::exp(growth, growth, n);               // exp((r - 0.5*sigma^2)*dt + sigma*sqrt(dt)*Z)
+            batches[k].advance(growth);
+        }
+        PRICER_LAP(timer, EVOLUTION);
+    }
+}
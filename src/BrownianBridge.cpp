@@ -0,0 +1,47 @@
+#include "BrownianBridge.h"
+#include <cmath>
+
+using namespace std;
+
+BrownianBridge::BrownianBridge(int n, double T)
+    : steps(n), bridgeIndex(n), leftIndex(n), rightIndex(n), leftWeight(n), rightWeight(n), stdDev(n), path(n) {
+    vector<double> t(n);
+    for (int i = 0; i < n; ++i) t[i] = T * (i + 1) / n;
+
+    // map[i] != 0 : le point t_i est dj construit
+    vector<int> map(n, 0);
+    map[n - 1] = 1;
+    bridgeIndex[0] = n - 1;
+    stdDev[0] = sqrt(t[n - 1]);
+    leftWeight[0] = rightWeight[0] = 0.0;
+
+    for (int i = 1, j = 0; i < n; ++i) {
+        while (map[j]) ++j;          // Premier point libre
+        int k = j;
+        while (!map[k]) ++k;         // Prochain point construit
+        int l = j + ((k - 1 - j) >> 1); // Milieu de l'intervalle libre
+        map[l] = i;
+        bridgeIndex[i] = l;
+        leftIndex[i] = j;
+        rightIndex[i] = k;
+        double tLeft = j ? t[j - 1] : 0.0;
+        leftWeight[i] = (t[k] - t[l]) / (t[k] - tLeft);
+        rightWeight[i] = (t[l] - tLeft) / (t[k] - tLeft);
+        stdDev[i] = sqrt((t[l] - tLeft) * (t[k] - t[l]) / (t[k] - tLeft));
+        j = k + 1;
+        if (j >= n) j = 0;
+    }
+}
+
+int BrownianBridge::getSteps() const { return steps; }
+
+void BrownianBridge::build(const double* z, double* dW, int stride) const {
+    path[steps - 1] = stdDev[0] * z[0]; // W(T)
+    for (int i = 1; i < steps; ++i) {
+        int j = leftIndex[i], k = rightIndex[i], l = bridgeIndex[i];
+        double left = j ? path[j - 1] : 0.0;
+        path[l] = leftWeight[i] * left + rightWeight[i] * path[k] + stdDev[i] * z[i];
+    }
+    dW[0] = path[0];
+    for (int i = 1; i < steps; ++i) dW[i * stride] = path[i] - path[i - 1];
+}
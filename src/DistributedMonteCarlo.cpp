@@ -0,0 +1,474 @@
+#include "DistributedMonteCarlo.h"
+#include "TradeArena.h"
+#include "ThreadPool.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DISTRIBUTED_SOCKETS
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Pas de SIGPIPE sur une connexion coupe : l'erreur est traite comme une rponse manquante
+#endif
+#endif
+
+using namespace std;
+
+static const char MAGIC[4] = { 'O', 'P', 'M', 'C' };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304; // Lu autrement par une machine d'un autre boutisme
+static const uint32_t MAX_PAYLOAD = 64u << 20;
+static const int MAX_OPTIONS = 4096;
+static const double MAX_MATURITY = 100.0;    // Annes : au-del, le nombre de pas (252 T) n'a plus de sens
+static const double CONNECT_TIMEOUT = 2.0;   // Secondes pour tablir la connexion  un worker
+static const double REPLY_TIMEOUT = 2.0;     // Secondes de marge pour la rponse  une tranche...
+static const double SECONDS_PER_STEP = 1e-7; // ... plus ce budget par (trajectoire, pas), ~25 fois le cot mesur
+
+enum RequestFlags { ANTITHETIC = 1, MOMENT_MATCHING = 2, CONTROL_VARIATE = 4 };
+enum ResponseStatus { STATUS_OK = 0, STATUS_ERROR = 1 };
+
+struct FrameHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t length; // Octets du contenu qui suit
+};
+
+// Contenu d'une requte : ShardRequest, puis nbOptions WireOption
+struct ShardRequest {
+    double maturity, spot, rate, volatility;
+    uint64_t seed;
+    int32_t nbSimulations, firstBlock, lastBlock, flags;
+    int32_t nbOptions, reserved;
+};
+
+struct WireOption {
+    int32_t type, reserved;
+    double strike;
+};
+
+// Contenu d'une rponse : ResponseHeader, puis (lastBlock - firstBlock) * nbOptions WireStats (ou le message d'erreur)
+struct ResponseHeader {
+    int32_t status, reserved;
+};
+
+// EstimatorStats  plat : paths, payoff et control, puis coM2
+struct WireStats {
+    int64_t count[3];
+    double mean[3], m2[3];
+    double coM2;
+};
+
+static_assert(sizeof(FrameHeader) == 16 && sizeof(ShardRequest) == 64 && sizeof(WireOption) == 16 &&
+              sizeof(ResponseHeader) == 8 && sizeof(WireStats) == 80, "protocole : structures sans bourrage");
+
+// (bloc, option) au plus dans une rponse : au-del, readFrame la refuserait
+static const size_t MAX_REPLY_STATS = (MAX_PAYLOAD - sizeof(ResponseHeader)) / sizeof(WireStats);
+
+static WireStats toWire(const EstimatorStats& stats) {
+    const RunningStats* parts[3] = { &stats.paths, &stats.payoff, &stats.control };
+    WireStats wire;
+    for (int i = 0; i < 3; ++i) {
+        wire.count[i] = parts[i]->count;
+        wire.mean[i] = parts[i]->mean;
+        wire.m2[i] = parts[i]->m2;
+    }
+    wire.coM2 = stats.coM2;
+    return wire;
+}
+
+static EstimatorStats fromWire(const WireStats& wire) {
+    EstimatorStats stats;
+    RunningStats* parts[3] = { &stats.paths, &stats.payoff, &stats.control };
+    for (int i = 0; i < 3; ++i) {
+        parts[i]->count = wire.count[i];
+        parts[i]->mean = wire.mean[i];
+        parts[i]->m2 = wire.m2[i];
+    }
+    stats.coM2 = wire.coM2;
+    return stats;
+}
+
+// Ajoute une structure  plat  la fin d'un message
+template <class T>
+static void append(vector<char>& payload, const T& value) {
+    const char* bytes = (const char*)&value;
+    payload.insert(payload.end(), bytes, bytes + sizeof(T));
+}
+
+#ifdef DISTRIBUTED_SOCKETS
+
+static bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= (size_t)sent;
+    }
+    return true;
+}
+
+static bool receiveAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, data, size, 0);
+        if (received <= 0) return false;
+        data += received;
+        size -= (size_t)received;
+    }
+    return true;
+}
+
+static bool writeFrame(int fd, const vector<char>& payload) {
+    FrameHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = DistributedMonteCarlo::PROTOCOL_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.length = (uint32_t)payload.size();
+    return sendAll(fd, (const char*)&header, sizeof(header)) && sendAll(fd, payload.data(), payload.size());
+}
+
+// false si la connexion est ferme, ou si l'en-tte n'est pas celui de ce protocole (version, boutisme, taille)
+static bool readFrame(int fd, vector<char>& payload) {
+    FrameHeader header;
+    if (!receiveAll(fd, (char*)&header, sizeof(header))) return false;
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != DistributedMonteCarlo::PROTOCOL_VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || header.length > MAX_PAYLOAD)
+        return false;
+    payload.resize(header.length);
+    return receiveAll(fd, payload.data(), payload.size());
+}
+
+static void setNoDelay(int fd) {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Petits messages : pas d'attente de Nagle
+}
+
+// Dlai maximal de chaque envoi et de chaque rception : une attente plus longue choue comme une connexion coupe
+static void setTimeout(int fd, double seconds) {
+    timeval delay;
+    delay.tv_sec = (time_t)seconds;
+    delay.tv_usec = (suseconds_t)((seconds - delay.tv_sec) * 1e6);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &delay, sizeof(delay));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &delay, sizeof(delay));
+}
+
+// Connexion  "hte:port" ; -1 si le worker est injoignable (SO_SNDTIMEO borne aussi connect sous Linux)
+static int connectTo(const string& host, const string& port) {
+    addrinfo hints, *addresses = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) return -1;
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd >= 0) setTimeout(fd, CONNECT_TIMEOUT);
+        if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd >= 0) setNoDelay(fd);
+    return fd;
+}
+
+static void sendError(int fd, const string& message) {
+    vector<char> payload;
+    ResponseHeader header = { STATUS_ERROR, 0 };
+    append(payload, header);
+    payload.insert(payload.end(), message.begin(), message.end());
+    writeFrame(fd, payload);
+}
+
+// Sert les requtes d'une connexion jusqu' sa fermeture (ou un message invalide)
+static void serveConnection(int fd, int nbThreads) {
+    TradeArena arena; // Options d'une requte, recres  chaque fois dans les mmes pages
+    vector<const Option*> options;
+    vector<char> request, response;
+    while (readFrame(fd, request)) {
+        ShardRequest shard;
+        if (request.size() < sizeof(shard)) break;
+        memcpy(&shard, request.data(), sizeof(shard));
+        if (shard.nbOptions < 1 || shard.nbOptions > MAX_OPTIONS ||
+            request.size() != sizeof(shard) + (size_t)shard.nbOptions * sizeof(WireOption))
+            break;
+
+        // Requte venue du rseau : march et maturit vrifis avant d'en tirer un nombre de pas ou une allocation
+        if (!(shard.maturity > 0.0 && shard.maturity <= MAX_MATURITY) || !(shard.spot > 0.0 && isfinite(shard.spot)) ||
+            !(shard.volatility > 0.0 && isfinite(shard.volatility)) || !isfinite(shard.rate) || shard.nbSimulations <= 0) {
+            sendError(fd, "worker : maturite, spot, taux, volatilite ou nombre de trajectoires invalide");
+            continue;
+        }
+        int nbBlocks = (shard.nbSimulations - 1) / MonteCarlo::BLOCK_SIZE + 1;
+        if (shard.firstBlock < 0 || shard.firstBlock >= shard.lastBlock || shard.lastBlock > nbBlocks ||
+            (size_t)(shard.lastBlock - shard.firstBlock) * shard.nbOptions > MAX_REPLY_STATS) {
+            sendError(fd, "worker : plage de blocs invalide ou reponse trop grande");
+            continue;
+        }
+
+        arena.reset();
+        options.clear();
+        for (int k = 0; k < shard.nbOptions; ++k) {
+            WireOption wire;
+            memcpy(&wire, request.data() + sizeof(shard) + k * sizeof(WireOption), sizeof(wire));
+            Option* option = wire.type > Option::CUSTOM && wire.type <= Option::GEOMETRIC_ASIAN_PUT && isfinite(wire.strike)
+                ? arena.createOption((Option::PayoffType)wire.type, shard.maturity, wire.strike) : nullptr;
+            if (!option) break;
+            options.push_back(option);
+        }
+        if ((int)options.size() != shard.nbOptions) {
+            sendError(fd, "worker : famille d'option inconnue ou strike invalide");
+            continue;
+        }
+
+        MonteCarloSettings settings(shard.seed, nbThreads);
+        settings.antithetic = (shard.flags & ANTITHETIC) != 0;
+        settings.momentMatching = (shard.flags & MOMENT_MATCHING) != 0;
+        settings.controlVariate = (shard.flags & CONTROL_VARIATE) != 0;
+        vector<EstimatorStats> blockStats;
+        try {
+            BlackScholesModel model(shard.spot, shard.rate, shard.volatility);
+            blockStats = MonteCarlo::blockStatistics(options, model, shard.nbSimulations, settings, shard.firstBlock, shard.lastBlock);
+        } catch (const exception& e) {
+            sendError(fd, string("worker : ") + e.what());
+            continue;
+        }
+
+        response.clear();
+        ResponseHeader header = { STATUS_OK, 0 };
+        append(response, header);
+        for (size_t i = 0; i < blockStats.size(); ++i) append(response, toWire(blockStats[i]));
+        if (!writeFrame(fd, response)) break;
+    }
+    close(fd);
+}
+
+void DistributedMonteCarlo::serve(int port, int nbThreads) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) throw runtime_error("DistributedMonteCarlo : creation de socket impossible");
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)); // Redmarrage immdiat sur le mme port
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)port);
+    if (port <= 0 || port > 65535 || ::bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        close(listener);
+        throw runtime_error("DistributedMonteCarlo : impossible d'ecouter sur le port " + to_string(port));
+    }
+    for (;;) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        setNoDelay(fd);
+        thread(serveConnection, fd, nbThreads).detach();
+    }
+}
+
+#else
+
+static int connectTo(const string&, const string&) { return -1; }
+static void setTimeout(int, double) {}
+static bool writeFrame(int, const vector<char>&) { return false; }
+static bool readFrame(int, vector<char>&) { return false; }
+static void close(int) {}
+
+void DistributedMonteCarlo::serve(int, int) {
+    throw runtime_error("DistributedMonteCarlo : sockets POSIX indisponibles sur ce systeme");
+}
+
+#endif
+
+// Statistiques d'une rponse du worker, ranges  partir de "stats" ; false (et la raison dans "error") si le worker
+// a renvoy une erreur ou une rponse de mauvaise taille
+static bool decodeResponse(const vector<char>& payload, EstimatorStats* stats, size_t count, string& error) {
+    ResponseHeader header;
+    if (payload.size() >= sizeof(header)) memcpy(&header, payload.data(), sizeof(header));
+    if (payload.size() >= sizeof(header) && header.status == STATUS_ERROR) {
+        error.assign(payload.begin() + sizeof(header), payload.end());
+        return false;
+    }
+    if (payload.size() < sizeof(header) || header.status != STATUS_OK || payload.size() != sizeof(header) + count * sizeof(WireStats)) {
+        error = "reponse invalide";
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        WireStats wire;
+        memcpy(&wire, payload.data() + sizeof(header) + i * sizeof(WireStats), sizeof(wire));
+        stats[i] = fromWire(wire);
+    }
+    return true;
+}
+
+// Tranches distribues  la demande. Celle d'un worker abandonn revient dans la file pour les workers restants ; un
+// worker sans tranche attend tant que d'autres en ont en cours (elles peuvent encore revenir).
+class ShardQueue {
+public:
+    explicit ShardQueue(int count): nbShards(count), next(0), inFlight(0) {}
+
+    // Prochaine tranche  simuler, -1 quand toutes ont rpondu ou ont t rendues sans worker pour les reprendre
+    int take() {
+        unique_lock<mutex> lock(access);
+        for (;;) {
+            if (!returned.empty()) {
+                int shard = returned.back();
+                returned.pop_back();
+                ++inFlight;
+                return shard;
+            }
+            if (next < nbShards) {
+                ++inFlight;
+                return next++;
+            }
+            if (inFlight == 0) return -1;
+            changed.wait(lock);
+        }
+    }
+
+    // Fin d'une tranche prise par take : simule, ou rendue par un worker abandonn
+    void finish(int shard, bool simulated) {
+        lock_guard<mutex> lock(access);
+        --inFlight;
+        if (!simulated) returned.push_back(shard);
+        changed.notify_all();
+    }
+
+private:
+    mutex access;
+    condition_variable changed;
+    int nbShards, next, inFlight;
+    vector<int> returned;
+};
+
+// Worker abandonn : signal sur la sortie d'erreur, en une seule criture (plusieurs threads peuvent le faire)
+static void warn(const string& worker, const string& reason) {
+    cerr << ("DistributedMonteCarlo : worker " + worker + " abandonne : " + reason + "\n") << flush;
+}
+
+vector<MonteCarloResult> DistributedMonteCarlo::estimateMany(const vector<const Option*>& options, const BlackScholesModel& model,
+                                                             int nbSimulations, const MonteCarloSettings& settings) {
+    if (options.empty()) return vector<MonteCarloResult>();
+    if (settings.workers.empty()) return MonteCarlo::estimateMany(options, model, nbSimulations, settings); // Mme rsultat, ici
+    PRICER_PROFILE_CALL("DistributedMonteCarlo::estimateMany");
+    if (settings.generator != MonteCarloSettings::PSEUDO_RANDOM)
+        throw invalid_argument("DistributedMonteCarlo : seul le generateur PSEUDO_RANDOM se repartit");
+    if ((int)options.size() > MAX_OPTIONS) throw invalid_argument("DistributedMonteCarlo : trop d'options dans un groupe");
+    for (size_t k = 0; k < options.size(); ++k) {
+        if (options[k]->payoffType() == Option::CUSTOM)
+            throw invalid_argument("DistributedMonteCarlo : un payoff CUSTOM ne peut pas etre envoye aux workers");
+        if (options[k]->getMaturity() != options[0]->getMaturity())
+            throw invalid_argument("MonteCarlo::estimateMany : toutes les options doivent avoir la meme maturite");
+    }
+    vector<string> hosts, ports;
+    for (size_t w = 0; w < settings.workers.size(); ++w) {
+        const string& worker = settings.workers[w];
+        size_t colon = worker.rfind(':');
+        if (colon == string::npos || colon == 0 || colon + 1 == worker.size())
+            throw invalid_argument("DistributedMonteCarlo : adresse de worker invalide (hote:port attendu) : " + worker);
+        hosts.push_back(worker.substr(0, colon));
+        ports.push_back(worker.substr(colon + 1));
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    const int BLOCK_SIZE = MonteCarlo::BLOCK_SIZE;
+    int nbOptions = options.size();
+    int nbWorkers = hosts.size();
+    int nbBlocks = (nbSimulations + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // Assez de tranches pour quilibrer des workers ingaux, chacune assez petite pour que sa rponse tienne dans un message
+    int shardSize = max(1, min(nbBlocks / (4 * nbWorkers), (int)(MAX_REPLY_STATS / nbOptions)));
+    int nbShards = (nbBlocks + shardSize - 1) / shardSize;
+    // Un worker muet au-del de ce dlai (bloqu, surcharg) est abandonn comme un worker dconnect
+    double replyTimeout = REPLY_TIMEOUT + SECONDS_PER_STEP * min(shardSize * BLOCK_SIZE, nbSimulations) *
+                                          (MonteCarlo::stepsFor(options[0]->getMaturity()) + nbOptions);
+
+    // Requte commune : seule la plage de blocs change d'une tranche  l'autre
+    vector<char> request;
+    ShardRequest shard;
+    memset(&shard, 0, sizeof(shard));
+    shard.maturity = options[0]->getMaturity();
+    shard.spot = model.getSpot();
+    shard.rate = model.getRate();
+    shard.volatility = model.getVolatility();
+    shard.seed = settings.seed;
+    shard.nbSimulations = nbSimulations;
+    shard.flags = (settings.antithetic ? ANTITHETIC : 0) | (settings.momentMatching ? MOMENT_MATCHING : 0) |
+                  (settings.controlVariate ? CONTROL_VARIATE : 0);
+    shard.nbOptions = nbOptions;
+    append(request, shard);
+    for (int k = 0; k < nbOptions; ++k) {
+        WireOption wire = { (int32_t)options[k]->payoffType(), 0, options[k]->getStrike() };
+        append(request, wire);
+    }
+
+    // Une connexion (et un thread) par worker ; les tranches sont prises  la demande
+    vector<EstimatorStats> blockStats((size_t)nbBlocks * nbOptions);
+    vector<char> done(nbShards, 0);
+    ShardQueue queue(nbShards);
+    ThreadPool::run(nbWorkers, nbWorkers, [&](int w) {
+        int fd = connectTo(hosts[w], ports[w]);
+        if (fd < 0) {
+            warn(settings.workers[w], "connexion impossible");
+            return;
+        }
+        setTimeout(fd, replyTimeout);
+        vector<char> message(request), response;
+        string error;
+        for (int s = queue.take(); s >= 0; s = queue.take()) {
+            int firstBlock = s * shardSize, lastBlock = min(firstBlock + shardSize, nbBlocks);
+            ShardRequest range = shard;
+            range.firstBlock = firstBlock;
+            range.lastBlock = lastBlock;
+            memcpy(message.data(), &range, sizeof(range));
+            if (!writeFrame(fd, message) || !readFrame(fd, response)) {
+                error = "pas de reponse (connexion coupee ou delai depasse)";
+            } else if (decodeResponse(response, &blockStats[(size_t)firstBlock * nbOptions],
+                                      (size_t)(lastBlock - firstBlock) * nbOptions, error)) {
+                error.clear();
+            }
+            if (!error.empty()) {
+                warn(settings.workers[w], error);
+                queue.finish(s, false); // Worker abandonn : sa tranche repart dans la file
+                break;
+            }
+            PRICER_COUNT(paths, min(lastBlock * BLOCK_SIZE, nbSimulations) - firstBlock * BLOCK_SIZE);
+            done[s] = 1;
+            queue.finish(s, true);
+        }
+        close(fd);
+    });
+
+    // Tranches sans rponse (plus aucun worker joignable) : simules ici, par plages contigus
+    int nbLocal = nbShards - (int)count(done.begin(), done.end(), 1);
+    if (nbLocal > 0)
+        cerr << "DistributedMonteCarlo : " << nbLocal << " tranche(s) sur " << nbShards
+             << " simulee(s) localement, faute de worker" << endl;
+    for (int s = 0; s < nbShards;) {
+        if (done[s]) { ++s; continue; }
+        int end = s;
+        while (end < nbShards && !done[end]) ++end;
+        int firstBlock = s * shardSize, lastBlock = min(end * shardSize, nbBlocks);
+        vector<EstimatorStats> local = MonteCarlo::blockStatistics(options, model, nbSimulations, settings, firstBlock, lastBlock);
+        copy(local.begin(), local.end(), blockStats.begin() + (size_t)firstBlock * nbOptions);
+        s = end;
+    }
+
+    vector<MonteCarloResult> results = MonteCarlo::resultsFromBlocks(options, model, settings, blockStats);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (size_t k = 0; k < results.size(); ++k) results[k].elapsedSeconds = elapsed;
+    return results;
+}
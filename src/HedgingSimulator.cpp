@@ -3,6 +3,14 @@
 #include <iomanip> // Configure l'affichage pour un format montaire lisible
 #include <cmath>
 #include <random>
+#include <algorithm>
+#include <chrono>
+#include "ThreadPool.h"
+#include "RunningStats.h"
+#include "SimdMath.h"
+#include "PathStore.h"
+#include "Instrumentation.h"
+#include <stdexcept>
 
 using namespace std;
 
@@ -63,3 +71,202 @@ void HedgingSimulator::run(const BlackScholesModel& initModel, double K, double
     cout << "A payer      : " << payoff << endl;
     cout << "P&L Hedging  : " << error << " (Idealement 0)" << endl;
 }
+
+// ------------------------------------- DISTRIBUTION DU P&L -------------------------------------
+
+HedgingSettings::HedgingSettings(int rebalances, double cost, int bins): nbRebalances(rebalances), transactionCost(cost), nbBins(bins) {}
+
+// Paquet de stratgies de couverture menes en parallle (SoA, tableaux sur la pile)
+struct HedgeBatch {
+    static const int LANES = 256;
+    double spot[LANES], logSpot[LANES], delta[LANES], bank[LANES];
+    double z[LANES], exponent[LANES], d1[LANES], newDelta[LANES];
+    uint32_t bits[LANES];
+};
+
+// Capitalisation du compte bancaire sur un pas
+SIMD_CLONES
+static void growBank(HedgeBatch& h, int n, double growth) {
+    for (int i = 0; i < n; ++i) h.bank[i] *= growth;
+}
+
+// March simul : log S avance de (r - sigma^2/2) dt + sigma sqrt(dt) Z, tir dans le flux du bloc
+struct SimulatedMarket {
+    RandomStream gen;
+    double drift, diffusion;
+
+    void move(HedgeBatch& h, long long, int lanes, int) {
+        PRICER_TIMER(timer);
+        gen.fill(h.bits, lanes);
+        SimdMath::normals(h.bits, h.z, lanes);
+        PRICER_LAP(timer, RANDOM);
+        PRICER_COUNT(draws, lanes);
+        for (int i = 0; i < lanes; ++i) h.logSpot[i] += drift + diffusion * h.z[i];
+        SimdMath::exp(h.logSpot, h.spot, lanes); // S(t) = exp(log S(t)) : un seul appel pour le paquet
+        PRICER_LAP(timer, EVOLUTION);
+    }
+};
+
+// March rejou : prix lus dans un fichier de trajectoires, une date de rajustement toutes les "stride" dates du fichier
+struct StoredMarket {
+    const PathStore& store;
+    int stride;
+    long long lastPath;
+
+    void move(HedgeBatch& h, long long begin, int lanes, int step) {
+        PRICER_PHASE(STORAGE);
+        for (int i = 0; i < lanes; ++i) h.spot[i] = store.path(min(begin + i, lastPath))[step * stride];
+        SimdMath::log(h.spot, h.logSpot, lanes);
+    }
+};
+
+// Nouveau Delta (w = 1 pour un Call, 0 pour un Put : N(d1) - 1), puis achat / vente de la diffrence, frais compris
+SIMD_CLONES
+static void rebalanceHedge(HedgeBatch& h, int n, double w, double cost) {
+    for (int i = 0; i < n; ++i) {
+        double target = h.newDelta[i] - 1.0 + w;
+        double traded = target - h.delta[i]; // Nombre d'actions achetes (> 0) ou vendues (< 0)
+        double amount = traded * h.spot[i];
+        h.bank[i] -= amount + cost * (amount < 0.0 ? -amount : amount);
+        h.delta[i] = target;
+    }
+}
+
+// Bilan  maturit : portefeuille (actions + banque) - payoff, pour chaque trajectoire
+SIMD_CLONES
+static void settleHedge(const HedgeBatch& h, int n, double K, bool isCall, double* pnl) {
+    for (int i = 0; i < n; ++i) {
+        double intrinsic = isCall ? h.spot[i] - K : K - h.spot[i];
+        pnl[i] = h.delta[i] * h.spot[i] + h.bank[i] - (intrinsic > 0.0 ? intrinsic : 0.0);
+    }
+}
+
+// Quantile empirique d'un chantillon tri (interpolation linaire entre les deux points encadrants)
+static double sortedQuantile(const vector<double>& sorted, double level) {
+    double position = level * (sorted.size() - 1);
+    size_t below = (size_t)position;
+    if (below + 1 >= sorted.size()) return sorted.back();
+    double weight = position - below;
+    return sorted[below] + weight * (sorted[below + 1] - sorted[below]);
+}
+
+// Couverture de nbPaths trajectoires sur "steps" dates, le march de chaque bloc tant fourni par makeMarket(bloc)
+template <class MarketFactory>
+static HedgingResult hedgeDistribution(const BlackScholesModel& model, double K, double T, bool isCall, long long nbPaths, int steps,
+                                       const HedgingSettings& hedging, int nbThreads, MarketFactory makeMarket) {
+    PRICER_PROFILE_CALL("HedgingSimulator::simulate");
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    const int BLOCK_SIZE = MonteCarlo::BLOCK_SIZE;
+    double dt = T / steps;
+    double S0 = model.getSpot();
+    double r = model.getRate();
+    double vol = model.getVolatility();
+    double cost = hedging.transactionCost;
+    double logS0 = log(S0);
+
+    // Tout ce qui ne dpend pas de la trajectoire est calcul une fois : prix et Delta initiaux,
+    // et pour chaque date de rajustement les termes de d1 = (log S + shift[i]) * scale[i]
+    double initPrice = model.bsPrice(K, T, isCall);
+    double initDelta = model.bsDelta(K, T, isCall);
+    double initBank = initPrice - initDelta * S0 - cost * fabs(initDelta) * S0;
+    double growth = exp(r * dt);
+    vector<double> shift(steps), scale(steps);
+    for (int i = 1; i < steps; ++i) {
+        double timeLeft = T - i * dt;
+        shift[i] = -log(K) + (r + 0.5 * vol * vol) * timeLeft;
+        scale[i] = 1.0 / (vol * sqrt(timeLeft));
+    }
+
+    vector<double> pnl((size_t)nbPaths);
+    int nbBlocks = (int)((nbPaths + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    vector<RunningStats> blockStats(nbBlocks);
+
+    ThreadPool::run(nbBlocks, nbThreads, [&](int b) {
+        auto market = makeMarket(b);
+        HedgeBatch h;
+        long long first = (long long)b * BLOCK_SIZE;
+        long long last = min(first + BLOCK_SIZE, nbPaths);
+        for (long long begin = first; begin < last; begin += HedgeBatch::LANES) {
+            int n = (int)min((long long)HedgeBatch::LANES, last - begin);
+            int lanes = n + (n & 1); // Box-Muller : nombre pair de normales
+            for (int i = 0; i < lanes; ++i) {
+                h.spot[i] = S0; h.logSpot[i] = logS0; h.delta[i] = initDelta; h.bank[i] = initBank;
+            }
+            for (int step = 1; step <= steps; ++step) {
+                market.move(h, begin, lanes, step); // Tirages, volution ou relecture mesurs par le march
+                PRICER_TIMER(timer);
+                growBank(h, lanes, growth);
+                if (step < steps) { // Rajustement avec le Delta au nouveau spot et au temps restant
+                    for (int i = 0; i < lanes; ++i) h.d1[i] = (h.logSpot[i] + shift[step]) * scale[step];
+                    SimdMath::normalCdf(h.d1, h.newDelta, lanes);
+                    rebalanceHedge(h, lanes, isCall ? 1.0 : 0.0, cost);
+                }
+                PRICER_LAP(timer, PAYOFF);
+            }
+            PRICER_TIMER(timer);
+            settleHedge(h, n, K, isCall, &pnl[begin]);
+            PRICER_LAP(timer, PAYOFF);
+            for (int i = 0; i < n; ++i) blockStats[b].add(pnl[begin + i]);
+            PRICER_LAP(timer, REDUCTION);
+            PRICER_COUNT(paths, n);
+        }
+    });
+
+    // Fusion dans l'ordre des blocs (rsultat reproductible)
+    RunningStats total;
+    for (int b = 0; b < nbBlocks; ++b) total.merge(blockStats[b]);
+
+    HedgingResult result;
+    result.nbPaths = nbPaths;
+    result.mean = total.mean;
+    result.stdDev = sqrt(total.variance());
+    result.stdError = total.stdError();
+    result.minimum = result.maximum = result.histogramLow = result.binWidth = 0.0;
+    if (nbPaths > 0) {
+        sort(pnl.begin(), pnl.end());
+        result.minimum = pnl.front();
+        result.maximum = pnl.back();
+        const double LEVELS[] = { 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99 };
+        for (size_t q = 0; q < sizeof(LEVELS) / sizeof(LEVELS[0]); ++q) {
+            result.quantileLevels.push_back(LEVELS[q]);
+            result.quantiles.push_back(sortedQuantile(pnl, LEVELS[q]));
+        }
+
+        // Histogramme sur [min, max] : le maximum tombe dans la dernire classe
+        int nbBins = max(1, hedging.nbBins);
+        result.histogramLow = result.minimum;
+        result.binWidth = (result.maximum - result.minimum) / nbBins;
+        result.histogram.assign(nbBins, 0);
+        for (size_t i = 0; i < pnl.size(); ++i) {
+            int bin = result.binWidth > 0.0 ? (int)((pnl[i] - result.minimum) / result.binWidth) : 0;
+            ++result.histogram[min(bin, nbBins - 1)];
+        }
+    }
+    result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+HedgingResult HedgingSimulator::simulate(const BlackScholesModel& model, double K, double T, bool isCall, int nbPaths,
+                                         const HedgingSettings& hedging, const MonteCarloSettings& settings) {
+    int steps = max(1, hedging.nbRebalances);
+    double dt = T / steps;
+    double vol = model.getVolatility();
+    double drift = (model.getRate() - 0.5 * vol * vol) * dt;
+    double diffusion = vol * sqrt(dt);
+    return hedgeDistribution(model, K, T, isCall, nbPaths, steps, hedging, settings.nbThreads, [&](int b) {
+        SimulatedMarket market = { RandomStream(settings.seed, b), drift, diffusion }; // Flux propre au bloc
+        return market;
+    });
+}
+
+HedgingResult HedgingSimulator::simulate(const PathStore& store, double K, bool isCall, const HedgingSettings& hedging, int nbThreads) {
+    int steps = hedging.nbRebalances > 0 ? hedging.nbRebalances : store.getSteps();
+    if (store.getSteps() % steps != 0)
+        throw invalid_argument("HedgingSimulator::simulate : le nombre de reajustements doit diviser le nombre de pas du fichier");
+    long long lastPath = store.getNbPaths() - 1;
+    int stride = store.getSteps() / steps;
+    return hedgeDistribution(store.getModel(), K, store.getMaturity(), isCall, store.getNbPaths(), steps, hedging, nbThreads, [&](int) {
+        StoredMarket market = { store, stride, lastPath };
+        return market;
+    });
+}
@@ -0,0 +1,266 @@
+#include "HestonModel.h"
+#include "SimdMath.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+HestonModel::HestonModel(double S0, double r, double variance, double k, double t, double x, double correlation)
+    : spot(S0), rate(r), v0(variance), kappa(k), theta(t), xi(x), rho(correlation) {
+    if (!(S0 > 0.0) || !(variance >= 0.0) || !(k > 0.0) || !(t > 0.0) || !(x > 0.0) || !(correlation >= -1.0 && correlation <= 1.0))
+        throw invalid_argument("HestonModel : S0, kappa, theta, xi > 0, v0 >= 0 et -1 <= rho <= 1");
+}
+
+double HestonModel::getSpot() const { return spot; }
+double HestonModel::getRate() const { return rate; }
+double HestonModel::getInitialVariance() const { return v0; }
+
+// ------------------------------------ FORMULE SEMI-ANALYTIQUE ------------------------------------
+
+// Noeuds et poids de Gauss-Legendre sur [-1, 1] (racines de P_N par Newton), calculs une fois
+struct GaussLegendre {
+    static const int NODES = 16;
+    double x[NODES], w[NODES];
+
+    GaussLegendre() {
+        const double PI = 3.14159265358979323846;
+        for (int i = 0; i < NODES / 2; ++i) {
+            double z = cos(PI * (i + 0.75) / (NODES + 0.5)), previous, derivative;
+            do {
+                double p1 = 1.0, p2 = 0.0;
+                for (int j = 1; j <= NODES; ++j) {
+                    double p3 = p2;
+                    p2 = p1;
+                    p1 = ((2.0 * j - 1.0) * z * p2 - (j - 1.0) * p3) / j;
+                }
+                derivative = NODES * (z * p1 - p2) / (z * z - 1.0);
+                previous = z;
+                z -= p1 / derivative;
+            } while (fabs(z - previous) > 1e-15);
+            x[i] = -z;
+            x[NODES - 1 - i] = z;
+            w[i] = w[NODES - 1 - i] = 2.0 / ((1.0 - z * z) * derivative * derivative);
+        }
+    }
+};
+
+static const GaussLegendre& gaussLegendre() {
+    static const GaussLegendre rule;
+    return rule;
+}
+
+// Fonction caractristique de X = log(S_T / S0) - r T prise en u complexe, avec a = i u : E[exp(a X)]
+// Forme "little trap" : g = (b - d) / (b + d) garde |g exp(-d T)| < 1, le logarithme complexe reste sur sa branche principale
+static complex<double> characteristic(complex<double> a, double T, double v0, double kappa, double theta, double xi, double rho) {
+    complex<double> b = kappa - rho * xi * a;
+    complex<double> d = sqrt(b * b + xi * xi * (a - a * a));
+    complex<double> g = (b - d) / (b + d);
+    complex<double> e = exp(-d * T);
+    complex<double> C = kappa * theta / (xi * xi) * ((b - d) * T - 2.0 * log((1.0 - g * e) / (1.0 - g)));
+    complex<double> D = (b - d) / (xi * xi) * (1.0 - e) / (1.0 - g * e);
+    return exp(C + D * v0);
+}
+
+double HestonModel::europeanPrice(double K, double T, bool isCall) const {
+    if (T <= 0.0) return isCall ? max(spot - K, 0.0) : max(K - spot, 0.0);
+    const double PI = 3.14159265358979323846;
+    double discount = exp(-rate * T);
+    double k = log(spot / K) + rate * T;
+
+    // Formule de Lewis (phi normalise par le forward F = S0 exp(r T), k = log(F / K)) :
+    // C = S0 - sqrt(S0 K) exp(-r T / 2) / pi * intgrale sur [0, +inf[ de Re[exp(i u k) phi(u - i/2)] / (u^2 + 1/4).
+    // Panneaux de Gauss-Legendre de largeur croissante (1/2, 1, 2, 4, puis 8 : le pic de 1 / (u^2 + 1/4) en 0 demande
+    // des panneaux troits, l'oscillation de exp(i u k) ensuite non) jusqu' ce que l'intgrande soit ngligeable sur
+    // tout un panneau : |phi| dcrot exponentiellement en u
+    const double WIDEST = 8.0;
+    const int MAX_PANELS = 1000;
+    const GaussLegendre& rule = gaussLegendre();
+    double integral = 0.0, start = 0.0, width = 0.5;
+    for (int j = 0; j < MAX_PANELS; ++j) {
+        double middle = start + 0.5 * width, half = 0.5 * width, largest = 0.0;
+        for (int i = 0; i < GaussLegendre::NODES; ++i) {
+            double u = middle + half * rule.x[i];
+            complex<double> a(0.5, u); // i (u - i/2)
+            complex<double> value = exp(complex<double>(0.0, u * k)) * characteristic(a, T, v0, kappa, theta, xi, rho);
+            integral += rule.w[i] * half * value.real() / (u * u + 0.25);
+            largest = max(largest, abs(value) / (u * u + 0.25));
+        }
+        start += width;
+        width = min(2.0 * width, WIDEST);
+        if (largest * width < 1e-14) break;
+    }
+    double call = spot - sqrt(spot * K) * exp(-0.5 * rate * T) / PI * integral;
+    call = max(call, max(spot - K * discount, 0.0)); // Bornes de non-arbitrage (erreur de quadrature loin de la monnaie)
+    return isCall ? call : max(call - spot + K * discount, 0.0);
+}
+
+// ------------------------------------------ SCHMA QE ------------------------------------------
+
+// Constantes d'un pas de longueur dt (le modle est homogne en temps : les mmes pour tous les pas).
+// log S(t+dt) = log S(t) + r dt + K0 + K1 v + K2 v' + sqrt(K3 v + K4 v') Zs (gamma1 = gamma2 = 1/2), K0 tant remplac
+// par sa version corrige (martingale) quand elle existe : A = K2 + K4 / 2 < 1 / (2a) (quadratique), A < beta (exponentielle)
+struct QeStep {
+    static constexpr double PSI_CRITICAL = 1.5; // Seuil quadratique / exponentielle recommand par Andersen
+    double theta, decay, c1, c2;                // m = theta + (v - theta) decay, s^2 = v c1 + c2
+    double drift, K0, K1, K2, K3, K4, A, K13;   // drift = r dt ; K13 = K1 + K3 / 2
+
+    QeStep(double r, double kappa, double th, double xi, double rho, double dt) {
+        theta = th;
+        decay = exp(-kappa * dt);
+        c1 = xi * xi * decay * (1.0 - decay) / kappa;
+        c2 = theta * xi * xi * (1.0 - decay) * (1.0 - decay) / (2.0 * kappa);
+        drift = r * dt;
+        K0 = -rho * kappa * theta * dt / xi;
+        K1 = 0.5 * dt * (kappa * rho / xi - 0.5) - rho / xi;
+        K2 = 0.5 * dt * (kappa * rho / xi - 0.5) + rho / xi;
+        K3 = K4 = 0.5 * dt * (1.0 - rho * rho);
+        A = K2 + 0.5 * K4;
+        K13 = K1 + 0.5 * K3;
+    }
+};
+
+// condition ? a : b par masque de bits (comme SimdMath.cpp) : le compilateur ne transforme pas en slection un ?:
+// entre deux calculs flottants, et la boucle ne se vectoriserait pas
+static inline double select(bool condition, double a, double b) {
+    uint64_t mask = 0 - (uint64_t)condition, x, y;
+    memcpy(&x, &a, sizeof(x));
+    memcpy(&y, &b, sizeof(y));
+    x = (x & mask) | (y & ~mask);
+    double result;
+    memcpy(&result, &x, sizeof(result));
+    return result;
+}
+
+// Paramtres des deux lois de v' pour la variance v : quadratique v' = a (b + Zv)^2, exponentielle de paramtre beta
+// avec une masse p en 0. Les deux sont calcules sans branchement ; psi <= PSI_CRITICAL choisit la quadratique.
+static inline void qeLaws(const QeStep& q, double v, double& psi, double& a, double& b2, double& p, double& beta) {
+    double m = q.theta + (v - q.theta) * q.decay;
+    psi = (v * q.c1 + q.c2) / (m * m);
+    double twoOverPsi = 2.0 / psi;
+    double excess = twoOverPsi - 1.0;
+    b2 = excess + sqrt(twoOverPsi) * sqrt(select(excess > 0.0, excess, 0.0));
+    a = m / (1.0 + b2);
+    p = (psi - 1.0) / (psi + 1.0);
+    beta = (1.0 - p) / m;
+}
+
+// Passe 1 : argument du logarithme de la correction de martingale dans correction (1 si elle n'existe pas), -Zv dans
+// tail ; rend le nombre de trajectoires en loi exponentielle
+SIMD_CLONES
+static int qePrepare(const QeStep& q, const double* __restrict variance, const double* __restrict z, int n,
+                     double* __restrict correction, double* __restrict tail) {
+    double exponential = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double psi, a, b2, p, beta;
+        qeLaws(q, variance[i], psi, a, b2, p, beta);
+        double quadratic = 1.0 - 2.0 * q.A * a;
+        double mixture = p + beta * (1.0 - p) / (beta - q.A);
+        double argument = select(psi <= QeStep::PSI_CRITICAL, quadratic, mixture);
+        correction[i] = select(argument > 0.0, argument, 1.0);
+        tail[i] = -z[i];
+        exponential += select(psi > QeStep::PSI_CRITICAL, 1.0, 0.0);
+    }
+    return (int)exponential;
+}
+
+// Passe 2 (loi exponentielle prsente) : tail = 1 - U = N(-Zv) en entre, (1 - p) / (1 - U) born  1 en sortie ;
+// log du rapport / beta = v' (0 si U <= p)
+SIMD_CLONES
+static void qeInversion(const QeStep& q, const double* __restrict variance, double* __restrict tail, int n) {
+    for (int i = 0; i < n; ++i) {
+        double psi, a, b2, p, beta;
+        qeLaws(q, variance[i], psi, a, b2, p, beta);
+        double ratio = (1.0 - p) / select(tail[i] > 1e-300, tail[i], 1e-300);
+        tail[i] = select(ratio > 1.0, ratio, 1.0);
+    }
+}
+
+// Passe 3 : v', partie dterministe de l'exposant (dans growth, qui contenait le log de la correction) et cart-type
+// du pas (dans scale, qui contenait le log du rapport de la loi exponentielle)
+SIMD_CLONES
+static void qeAdvance(const QeStep& q, double* __restrict variance, const double* __restrict z, int n,
+                      double* __restrict growth, double* __restrict scale) {
+    for (int i = 0; i < n; ++i) {
+        double v = variance[i];
+        double psi, a, b2, p, beta;
+        qeLaws(q, v, psi, a, b2, p, beta);
+        double b = sqrt(b2);
+        double quadraticNext = a * (b + z[i]) * (b + z[i]);
+        double exponentialNext = scale[i] / beta;
+        double logCorrection = growth[i];
+        double quadraticK0 = -q.A * b2 * a / (1.0 - 2.0 * q.A * a) + 0.5 * logCorrection - q.K13 * v;
+        double exponentialK0 = -logCorrection - q.K13 * v;
+        bool quadratic = psi <= QeStep::PSI_CRITICAL;
+        bool corrected = select(quadratic, 1.0 - 2.0 * q.A * a, beta - q.A) > 0.0;
+        double next = select(quadratic, quadraticNext, exponentialNext);
+        double K0 = select(corrected, select(quadratic, quadraticK0, exponentialK0), q.K0);
+        growth[i] = q.drift + K0 + q.K1 * v + q.K2 * next;
+        scale[i] = sqrt(q.K3 * v + q.K4 * next);
+        variance[i] = next;
+    }
+}
+
+void HestonModel::generatePath(double T, int steps, vector<double>& path, RandomStream& gen) const {
+    PRICER_PHASE(EVOLUTION);
+    PRICER_COUNT(draws, 2 * steps);
+    QeStep q(rate, kappa, theta, xi, rho, T / steps);
+    normal_distribution<> normal(0.0, 1.0);
+    double S = spot, v = v0;
+    path.clear();
+    path.push_back(S);
+    for (int k = 0; k < steps; ++k) {
+        double zv = normal(gen), zs = normal(gen);
+        double psi, a, b2, p, beta, next, K0 = q.K0;
+        qeLaws(q, v, psi, a, b2, p, beta);
+        if (psi <= QeStep::PSI_CRITICAL) {
+            double b = sqrt(b2);
+            next = a * (b + zv) * (b + zv);
+            double argument = 1.0 - 2.0 * q.A * a;
+            if (argument > 0.0) K0 = -q.A * b2 * a / argument + 0.5 * log(argument) - q.K13 * v;
+        } else {
+            double tail = 0.5 * erfc(zv / sqrt(2.0)); // 1 - U, U = N(Zv)
+            next = tail < 1.0 - p ? log((1.0 - p) / tail) / beta : 0.0;
+            if (beta > q.A) K0 = -log(p + beta * (1.0 - p) / (beta - q.A)) - q.K13 * v;
+        }
+        S *= exp(q.drift + K0 + q.K1 * v + q.K2 * next + sqrt(q.K3 * v + q.K4 * next) * zs);
+        v = next;
+        path.push_back(S);
+    }
+}
+
+void HestonModel::generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling) const {
+    QeStep q(rate, kappa, theta, xi, rho, T / steps);
+    int n = batch.size;
+    batch.start(spot, steps);
+    fill(batch.variance.begin(), batch.variance.end(), v0);
+    double* z = batch.normals.data();
+    double* growth = batch.growth.data();
+    double* scale = batch.scale.data();
+    double* variance = batch.variance.data();
+    PRICER_TIMER(timer);
+    for (int k = 0; k < steps; ++k) {
+        batch.drawNormals(gen, sampling); // Zv
+        PRICER_LAP(timer, RANDOM);
+        int exponential = qePrepare(q, variance, z, n, growth, scale);
+        if (exponential > 0) { // Variance proche de 0 : inversion de la loi exponentielle
+            SimdMath::normalCdf(scale, scale, n);
+            qeInversion(q, variance, scale, n);
+            SimdMath::log(scale, scale, n);
+        }
+        SimdMath::log(growth, growth, n);
+        qeAdvance(q, variance, z, n, growth, scale);
+        PRICER_LAP(timer, EVOLUTION);
+        batch.drawNormals(gen, sampling); // Zs, indpendante de Zv (la corrlation est dans K0..K4)
+        PRICER_LAP(timer, RANDOM);
+        for (int i = 0; i < n; ++i) growth[i] += scale[i] * z[i];
+        batch.advanceLogs(growth);
+        SimdMath::exp(growth, growth, n);
+        batch.advance(growth);
+        PRICER_LAP(timer, EVOLUTION);
+    }
+}
@@ -0,0 +1,120 @@
+#include "ImpliedVolatility.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace std;
+
+// tat de l'inversion pour une cotation
+struct VolSearch {
+    double target;   // Prix  retrouver
+    double sigma;    // Estimation courante
+    double low;      // sigma trop faible (prix < cible)
+    double high;     // sigma trop fort (prix > cible), infini au dpart
+    double logMoneyness;
+    bool done;
+};
+
+// Initialise la recherche : bornes d'arbitrage puis point de dpart. Renvoie false si la cotation est rgle d'office.
+static bool startSearch(double S, double r, double price, double K, double T, bool isCall, VolSearch& search, double& vol) {
+    double X = K * exp(-r * T); // Strike actualis
+    double lower = isCall ? max(S - X, 0.0) : max(X - S, 0.0);
+    double upper = isCall ? S : X;
+    if (!(T > 0.0) || !(price >= lower) || !(price < upper)) { vol = numeric_limits<double>::quiet_NaN(); return false; }
+    if (price == lower) { vol = 0.0; return false; }
+
+    // Corrado-Miller sur le prix du Call quivalent (parit Call-Put)
+    double C = isCall ? price : price + S - X;
+    double a = C - 0.5 * (S - X);
+    double disc = max(a * a - (S - X) * (S - X) / M_PI, 0.0);
+    double guess = sqrt(2.0 * M_PI / T) / (S + X) * (a + sqrt(disc));
+    if (!(guess > 1e-3)) guess = sqrt(2.0 * fabs(log(S / X)) / T); // Manaster-Koehler : point d'inflexion du prix en sigma
+    guess = min(max(guess, 1e-3), 5.0);
+
+    search.target = price;
+    search.sigma = guess;
+    search.low = 0.0;
+    search.high = numeric_limits<double>::infinity();
+    search.logMoneyness = log(S / K);
+    search.done = false;
+    return true;
+}
+
+// Un pas de Halley  partir du prix et du vega en sigma, avec repli sur la bissection
+static void updateSearch(double r, double T, double price, double vega, double tolerance, VolSearch& search) {
+    double sigma = search.sigma;
+    double f = price - search.target;
+    if (fabs(f) <= tolerance) { search.done = true; return; }
+    if (f > 0.0) search.high = sigma; else search.low = sigma;
+
+    double next = -1.0;
+    if (vega > 1e-300) {
+        // Volga = Vega * d1 * d2 / sigma : correction d'ordre 2 (Halley)
+        double sqrtT = sqrt(T);
+        double d1 = (search.logMoneyness + (r + 0.5 * sigma * sigma) * T) / (sigma * sqrtT);
+        double d2 = d1 - sigma * sqrtT;
+        double newton = f / vega;
+        double halley = 1.0 - 0.5 * newton * d1 * d2 / sigma;
+        next = sigma - (halley > 0.5 ? newton / halley : newton);
+    }
+    if (!(next > search.low && next < search.high)) // Hors de l'encadrement : bissection (ou doublement tant que high est infini)
+        next = isinf(search.high) ? 2.0 * sigma : 0.5 * (search.low + search.high);
+
+    if (fabs(next - sigma) <= 1e-15 * sigma) search.done = true;
+    search.sigma = next;
+}
+
+double ImpliedVolatility::solve(const BlackScholesModel& market, double price, double K, double T, bool isCall, double tolerance) {
+    double S = market.getSpot();
+    double r = market.getRate();
+    VolSearch search;
+    double vol;
+    if (!startSearch(S, r, price, K, T, isCall, search, vol)) return vol;
+
+    for (int it = 0; it < MAX_ITERATIONS && !search.done; ++it) {
+        BlackScholesModel trial(S, r, search.sigma);
+        updateSearch(r, T, trial.bsPrice(K, T, isCall), trial.bsVega(K, T), tolerance, search);
+    }
+    return search.sigma;
+}
+
+void ImpliedVolatility::solveBatch(const BlackScholesModel& market, const double* prices, const double* K, const double* T,
+                                   const bool* isCall, int n, double* vols, double tolerance) {
+    double S = market.getSpot();
+    double r = market.getRate();
+    vector<VolSearch> searches(n);
+    vector<int> started; // Cotations  inverser (les autres ont dj leur valeur : NaN ou 0)
+    started.reserve(n);
+    for (int i = 0; i < n; ++i)
+        if (startSearch(S, r, prices[i], K[i], T[i], isCall[i], searches[i], vols[i])) started.push_back(i);
+    vector<int> active(started); // Indices des cotations encore en cours
+
+    // Tampons contigus des contrats actifs (rutiliss  chaque itration)
+    vector<double> k(n), t(n), sigma(n), price(n), delta(n), gamma(n), vega(n);
+    unique_ptr<bool[]> call(new bool[n]);
+
+    for (int it = 0; it < MAX_ITERATIONS && !active.empty(); ++it) {
+        int m = (int)active.size();
+        for (int j = 0; j < m; ++j) {
+            int i = active[j];
+            k[j] = K[i]; t[j] = T[i]; call[j] = isCall[i]; sigma[j] = searches[i].sigma;
+        }
+        market.bsBatch(k.data(), t.data(), call.get(), sigma.data(), m, price.data(), delta.data(), gamma.data(), vega.data());
+
+        // Mise  jour et compactage : on ne garde que les cotations non converges
+        int remaining = 0;
+        for (int j = 0; j < m; ++j) {
+            int i = active[j];
+            updateSearch(r, T[i], price[j], vega[j], tolerance, searches[i]);
+            if (!searches[i].done) active[remaining++] = i;
+        }
+        active.resize(remaining);
+    }
+    for (size_t j = 0; j < started.size(); ++j) vols[started[j]] = searches[started[j]].sigma;
+}
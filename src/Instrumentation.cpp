@@ -0,0 +1,172 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+#ifndef PRICER_NO_INSTRUMENTATION
+const bool Instrumentation::ENABLED = true;
+#else
+const bool Instrumentation::ENABLED = false;
+#endif
+bool Instrumentation::allocationsCounted = false; // Mis  true par AllocationCounter.cpp s'il est li
+
+const char* Instrumentation::phaseName(Phase phase) {
+    static const char* names[NB_PHASES] = { "tirages", "evolution", "stockage", "payoff", "reduction" };
+    return phase >= 0 && phase < NB_PHASES ? names[phase] : "?";
+}
+
+double Instrumentation::secondsPerTick() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    // Frquence du compteur de cycles mesure sur 2 ms, une seule fois
+    static const double value = []() {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        long long first = ticks();
+        double elapsed = 0.0;
+        while (elapsed < 2e-3) elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return elapsed / (double)(ticks() - first);
+    }();
+    return value;
+#else
+    return 1e-9;
+#endif
+}
+
+// ------------------------------------------- PROFILS -------------------------------------------
+
+PricingProfile::PricingProfile(): elapsedSeconds(0.0), otherSeconds(0.0), paths(0), draws(0), allocations(0) {
+    for (int p = 0; p < Instrumentation::NB_PHASES; ++p) phaseSeconds[p] = 0.0;
+}
+
+double PricingProfile::pathsPerSecond() const {
+    return elapsedSeconds > 0.0 ? paths / elapsedSeconds : 0.0;
+}
+
+double PricingProfile::loadImbalance() const {
+    double total = 0.0, busiest = 0.0;
+    for (size_t t = 0; t < threads.size(); ++t) {
+        total += threads[t].busySeconds;
+        busiest = max(busiest, threads[t].busySeconds);
+    }
+    return total > 0.0 ? busiest * threads.size() / total : 1.0;
+}
+
+string PricingProfile::summary() const {
+    ostringstream out;
+    out << "--- Profil " << engine << " : " << elapsedSeconds << " s ---" << endl;
+    out << "Trajectoires : " << paths << " (" << (long long)pathsPerSecond() << " /s), tirages : " << draws;
+    if (Instrumentation::allocationsCounted) out << ", allocations : " << allocations;
+    out << endl;
+    double busy = otherSeconds;
+    for (int p = 0; p < Instrumentation::NB_PHASES; ++p) busy += phaseSeconds[p];
+    out << "Phases (temps cumule des threads) :";
+    for (int p = 0; p <= Instrumentation::NB_PHASES; ++p) {
+        double seconds = p < Instrumentation::NB_PHASES ? phaseSeconds[p] : otherSeconds;
+        char share[32];
+        snprintf(share, sizeof(share), "%.1f%%", busy > 0.0 ? 100.0 * seconds / busy : 0.0);
+        out << (p ? ", " : " ") << (p < Instrumentation::NB_PHASES ? Instrumentation::phaseName((Instrumentation::Phase)p) : "autre")
+            << " " << seconds << " s (" << share << ")";
+    }
+    out << endl << "Threads : " << threads.size() << ", desequilibre de charge " << loadImbalance() << endl;
+    for (size_t t = 0; t < threads.size(); ++t)
+        out << "  thread " << t << " : " << threads[t].tasks << " taches, " << threads[t].paths << " trajectoires, "
+            << threads[t].busySeconds << " s" << endl;
+    return out.str();
+}
+
+// -------------------------------------------- APPELS --------------------------------------------
+
+static thread_local Instrumentation::Call* currentCall = nullptr;
+static thread_local PricingProfile lastCallProfile;
+static mutex observerAccess;
+static function<void(const PricingProfile&)> observer;
+
+struct Instrumentation::Call::State {
+    PricingProfile profile;
+    chrono::steady_clock::time_point start;
+    Counters before;       // Compteurs du thread appelant au dbut de l'appel
+    Counters others;       // Somme des travaux des autres threads du pool
+    mutex access;
+};
+
+static void accumulate(Instrumentation::Counters& total, const Instrumentation::Counters& before, const Instrumentation::Counters& after) {
+    for (int p = 0; p < Instrumentation::NB_PHASES; ++p) total.ticks[p] += after.ticks[p] - before.ticks[p];
+    total.paths += after.paths - before.paths;
+    total.draws += after.draws - before.draws;
+    total.allocations += after.allocations - before.allocations;
+}
+
+Instrumentation::Call::Call(const char* engine): state(nullptr) {
+    if (currentCall) return; // Appel imbriqu : mesur par l'appel externe
+    state = new State();
+    state->profile.engine = engine;
+    state->start = chrono::steady_clock::now();
+    state->before = local();
+    state->others = Counters();
+    currentCall = this;
+}
+
+Instrumentation::Call::~Call() {
+    if (!state) return;
+    currentCall = nullptr;
+    Counters total = state->others;
+    accumulate(total, state->before, local());
+
+    PricingProfile& profile = state->profile;
+    profile.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - state->start).count();
+    double tick = secondsPerTick();
+    double phases = 0.0;
+    for (int p = 0; p < NB_PHASES; ++p) {
+        profile.phaseSeconds[p] = total.ticks[p] * tick;
+        phases += profile.phaseSeconds[p];
+    }
+    double busy = 0.0;
+    for (size_t t = 0; t < profile.threads.size(); ++t) busy += profile.threads[t].busySeconds;
+    profile.otherSeconds = max(0.0, busy - phases);
+    profile.paths = total.paths;
+    profile.draws = total.draws;
+    profile.allocations = total.allocations;
+
+    lastCallProfile = profile;
+    delete state;
+    function<void(const PricingProfile&)> notify;
+    {
+        lock_guard<mutex> lock(observerAccess);
+        notify = observer;
+    }
+    if (notify) notify(lastCallProfile);
+}
+
+Instrumentation::Call* Instrumentation::Call::current() {
+    return currentCall;
+}
+
+void Instrumentation::Call::setCurrent(Call* call) {
+    currentCall = call;
+}
+
+void Instrumentation::Call::addWorker(int worker, const Counters& before, const Counters& after, long long busyTicks, int nbTasks) {
+    if (!state) return;
+    lock_guard<mutex> lock(state->access);
+    if (worker > 0) accumulate(state->others, before, after); // Le thread appelant est compt  la fin de l'appel
+    vector<ThreadProfile>& threads = state->profile.threads;
+    if ((int)threads.size() <= worker) {
+        ThreadProfile idle = { 0, 0, 0.0 };
+        threads.resize(worker + 1, idle);
+    }
+    threads[worker].tasks += nbTasks;
+    threads[worker].paths += after.paths - before.paths;
+    threads[worker].busySeconds += busyTicks * secondsPerTick();
+}
+
+const PricingProfile& Instrumentation::lastProfile() {
+    return lastCallProfile;
+}
+
+void Instrumentation::setObserver(const function<void(const PricingProfile&)>& callback) {
+    lock_guard<mutex> lock(observerAccess);
+    observer = callback;
+}
@@ -0,0 +1,246 @@
+#include "LocalVolatilityModel.h"
+#include "SimdMath.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+// ----------------------------------------- STRUCTURES PAR TERME -----------------------------------------
+
+TermStructure::TermStructure(double value): values(1, value) {}
+
+TermStructure::TermStructure(const vector<double>& t, const vector<double>& v): times(t), values(v) {
+    if (t.empty() || t.size() != v.size()) throw invalid_argument("TermStructure : autant de dates que de valeurs (au moins une)");
+    for (size_t i = 0; i < t.size(); ++i)
+        if (!(t[i] > (i > 0 ? t[i - 1] : 0.0))) throw invalid_argument("TermStructure : dates strictement positives et croissantes");
+}
+
+double TermStructure::value(double t) const {
+    size_t i = lower_bound(times.begin(), times.end(), t) - times.begin();
+    return values[min(i, values.size() - 1)];
+}
+
+double TermStructure::primitive(double t, bool squared) const {
+    double total = 0.0, previous = 0.0;
+    for (size_t i = 0; i < times.size() && previous < t; ++i) {
+        double end = min(t, times[i]);
+        total += (end - previous) * (squared ? values[i] * values[i] : values[i]);
+        previous = end;
+    }
+    if (previous < t) total += (t - previous) * (squared ? values.back() * values.back() : values.back()); // Au-del du dernier point
+    return total;
+}
+
+double TermStructure::integral(double t0, double t1) const {
+    return primitive(t1, false) - primitive(t0, false);
+}
+
+double TermStructure::squaredIntegral(double t0, double t1) const {
+    return primitive(t1, true) - primitive(t0, true);
+}
+
+// --------------------------------------- SURFACE DE VOLATILIT LOCALE ---------------------------------------
+
+LocalVolSurface::LocalVolSurface(const vector<double>& t, const vector<double>& spots, const vector<double>& v): times(t), vols(v) {
+    if (t.empty() || spots.empty() || v.size() != t.size() * spots.size())
+        throw invalid_argument("LocalVolSurface : grille vide ou nombre de volatilites different de dates x spots");
+    for (size_t i = 0; i < t.size(); ++i)
+        if (t[i] < 0.0 || (i > 0 && !(t[i] > t[i - 1]))) throw invalid_argument("LocalVolSurface : dates positives et croissantes");
+    for (size_t j = 0; j < spots.size(); ++j) {
+        if (!(spots[j] > (j > 0 ? spots[j - 1] : 0.0))) throw invalid_argument("LocalVolSurface : spots positifs et croissants");
+        logSpots.push_back(log(spots[j]));
+    }
+    for (size_t k = 0; k < v.size(); ++k)
+        if (!(v[k] > 0.0)) throw invalid_argument("LocalVolSurface : volatilites strictement positives");
+}
+
+// Intervalle [i, i + 1] de la grille qui contient x, et poids w de grid[i + 1] (w = 0 hors de la grille : prolongement  plat)
+static void locate(const vector<double>& grid, double x, size_t& i, double& w) {
+    if (x <= grid.front()) { i = 0; w = 0.0; return; }
+    if (x >= grid.back()) { i = grid.size() - 1; w = 0.0; return; }
+    i = upper_bound(grid.begin(), grid.end(), x) - grid.begin() - 1;
+    w = (x - grid[i]) / (grid[i + 1] - grid[i]);
+}
+
+double LocalVolSurface::volatility(double S, double t) const {
+    size_t i, j;
+    double wt, ws;
+    locate(times, t, i, wt);
+    locate(logSpots, log(S), j, ws);
+    size_t nbSpots = logSpots.size();
+    const double* row = &vols[i * nbSpots];
+    double value = ws > 0.0 ? (1.0 - ws) * row[j] + ws * row[j + 1] : row[j];
+    if (wt > 0.0) {
+        const double* next = row + nbSpots;
+        value = (1.0 - wt) * value + wt * (ws > 0.0 ? (1.0 - ws) * next[j] + ws * next[j + 1] : next[j]);
+    }
+    return value;
+}
+
+double LocalVolSurface::lowestSpot() const { return exp(logSpots.front()); }
+double LocalVolSurface::highestSpot() const { return exp(logSpots.back()); }
+
+// ------------------------------------------------- MODLE -------------------------------------------------
+
+// Constantes des pas d'une simulation (T, steps) : exposant S(t+dt) / S(t) = drift + diffusion * Z, moins
+// halfDt * sigma(S, t)^2 en volatilit locale, sigma tant lu dans la ligne du pas (SPOT_NODES valeurs, x = log S
+// rgulier  partir de x0)
+struct LocalVolatilityModel::StepTables {
+    double T;
+    int steps;
+    vector<double> drift, diffusion;
+    double halfDt, x0, inverseDx;
+    vector<double> nodes; // nodes[step * ROW + j] = sigma(exp(x0 + j * dx), dbut du pas), j < SPOT_NODES ; puis une case de bourrage
+    static const int ROW = SPOT_NODES + 1;
+};
+
+struct LocalVolatilityModel::TableCache {
+    static const size_t CAPACITY = 16;
+    mutex access;
+    vector<shared_ptr<const StepTables> > entries; // Les plus rcentes  la fin
+};
+
+LocalVolatilityModel::LocalVolatilityModel(double S0, const TermStructure& r, const TermStructure& sigma): spot(S0), rate(r),
+    timeVolatility(sigma), cache(new TableCache()) {}
+
+LocalVolatilityModel::LocalVolatilityModel(double S0, const TermStructure& r, const LocalVolSurface& localVol): spot(S0), rate(r),
+    surface(new LocalVolSurface(localVol)), cache(new TableCache()) {}
+
+double LocalVolatilityModel::getSpot() const { return spot; }
+bool LocalVolatilityModel::isLocal() const { return surface != nullptr; }
+
+double LocalVolatilityModel::volatility(double S, double t) const {
+    return surface ? surface->volatility(S, t) : timeVolatility.value(t);
+}
+
+double LocalVolatilityModel::discountFactor(double T) const {
+    return exp(-rate.integral(0.0, T));
+}
+
+BlackScholesModel LocalVolatilityModel::flatEquivalent(double T) const {
+    if (surface) throw invalid_argument("LocalVolatilityModel::flatEquivalent : une volatilite locale n'a pas d'equivalent plat");
+    return BlackScholesModel(spot, rate.integral(0.0, T) / T, sqrt(timeVolatility.squaredIntegral(0.0, T) / T));
+}
+
+shared_ptr<const LocalVolatilityModel::StepTables> LocalVolatilityModel::tablesFor(double T, int steps) const {
+    lock_guard<mutex> lock(cache->access);
+    vector<shared_ptr<const StepTables> >& entries = cache->entries;
+    for (size_t e = 0; e < entries.size(); ++e)
+        if (entries[e]->T == T && entries[e]->steps == steps) return entries[e];
+
+    shared_ptr<StepTables> tables(new StepTables());
+    tables->T = T;
+    tables->steps = steps;
+    tables->drift.resize(steps);
+    tables->diffusion.resize(steps);
+    double dt = T / steps;
+    for (int k = 0; k < steps; ++k) {
+        double t0 = T * k / steps, t1 = T * (k + 1) / steps;
+        double growthRate = rate.integral(t0, t1);
+        if (surface) {
+            tables->drift[k] = growthRate;
+            tables->diffusion[k] = sqrt(dt);
+        } else {
+            double variance = timeVolatility.squaredIntegral(t0, t1); // Pas exact : log S est gaussien
+            tables->drift[k] = growthRate - 0.5 * variance;
+            tables->diffusion[k] = sqrt(variance);
+        }
+    }
+    tables->halfDt = 0.5 * dt;
+    if (surface) {
+        double low = log(surface->lowestSpot()), high = log(surface->highestSpot());
+        if (high - low < 1e-12) { // Un seul spot : la surface ne dpend pas de S
+            low = log(spot) - 1.0;
+            high = log(spot) + 1.0;
+        }
+        double dx = (high - low) / (SPOT_NODES - 1);
+        tables->x0 = low;
+        tables->inverseDx = 1.0 / dx;
+        tables->nodes.resize((size_t)steps * StepTables::ROW);
+        for (int k = 0; k < steps; ++k) {
+            double* row = &tables->nodes[(size_t)k * StepTables::ROW];
+            for (int j = 0; j < SPOT_NODES; ++j) row[j] = surface->volatility(exp(low + j * dx), T * k / steps);
+            row[SPOT_NODES] = row[SPOT_NODES - 1];
+        }
+    }
+
+    if (entries.size() == TableCache::CAPACITY) entries.erase(entries.begin());
+    entries.push_back(tables);
+    return tables;
+}
+
+// sigma au point x = log S, interpol dans la ligne du pas ( plat hors de la grille). Bornes sans comparaison
+// (max(a, 0) = (a + |a|) / 2) pour que la boucle du paquet se vectorise ; u = SPOT_NODES - 1 lit la case de bourrage.
+static inline double nodeVolatility(const double* row, double x, double x0, double inverseDx) {
+    const double highest = LocalVolatilityModel::SPOT_NODES - 1;
+    double u = (x - x0) * inverseDx;
+    u = 0.5 * (u + fabs(u));
+    u = highest - 0.5 * ((highest - u) + fabs(highest - u));
+    int j = (int)u;
+    double w = u - j;
+    return row[j] + w * (row[j + 1] - row[j]);
+}
+
+// Exposants d'un pas d'Euler en log S pour tout le paquet
+SIMD_CLONES
+static void localGrowth(const double* __restrict logSpot, const double* __restrict z, const double* __restrict row, double x0,
+                        double inverseDx, double drift, double halfDt, double diffusion, double* __restrict growth, int n) {
+    for (int i = 0; i < n; ++i) {
+        double sigma = nodeVolatility(row, logSpot[i], x0, inverseDx);
+        growth[i] = drift - halfDt * sigma * sigma + diffusion * sigma * z[i];
+    }
+}
+
+void LocalVolatilityModel::generatePath(double T, int steps, vector<double>& path, RandomStream& gen) const {
+    shared_ptr<const StepTables> tables = tablesFor(T, steps);
+    PRICER_PHASE(EVOLUTION);
+    PRICER_COUNT(draws, steps);
+    normal_distribution<> normal(0.0, 1.0);
+    double S = spot, x = log(spot);
+    path.clear();
+    path.push_back(S);
+    for (int k = 0; k < steps; ++k) {
+        double Z = normal(gen);
+        double exponent;
+        if (surface) {
+            double sigma = nodeVolatility(&tables->nodes[(size_t)k * StepTables::ROW], x, tables->x0, tables->inverseDx);
+            exponent = tables->drift[k] - tables->halfDt * sigma * sigma + tables->diffusion[k] * sigma * Z;
+        } else {
+            exponent = tables->drift[k] + tables->diffusion[k] * Z;
+        }
+        x += exponent;
+        S *= exp(exponent);
+        path.push_back(S);
+    }
+}
+
+void LocalVolatilityModel::generateBatch(double T, int steps, PathBatch& batch, RandomStream& gen, int sampling) const {
+    shared_ptr<const StepTables> tables = tablesFor(T, steps);
+    int n = batch.size;
+    batch.start(spot, steps);
+    double* z = batch.normals.data();
+    double* growth = batch.growth.data();
+    double* logSpot = batch.logLast.data(); // log S toujours suivi : la volatilit locale en dpend
+    PRICER_TIMER(timer);
+    for (int k = 0; k < steps; ++k) {
+        batch.drawNormals(gen, sampling);
+        PRICER_LAP(timer, RANDOM);
+        if (surface) {
+            localGrowth(logSpot, z, &tables->nodes[(size_t)k * StepTables::ROW], tables->x0, tables->inverseDx,
+                        tables->drift[k], tables->halfDt, tables->diffusion[k], growth, n);
+            if (!(batch.tracking & PathBatch::LOG_SUM))
+                for (int i = 0; i < n; ++i) logSpot[i] += growth[i];
+        } else {
+            double drift = tables->drift[k], diffusion = tables->diffusion[k];
+            for (int i = 0; i < n; ++i) growth[i] = drift + diffusion * z[i];
+        }
+        batch.advanceLogs(growth);
+        SimdMath::exp(growth, growth, n);
+        batch.advance(growth);
+        PRICER_LAP(timer, EVOLUTION);
+    }
+}
@@ -1,37 +1,754 @@
 #include "MonteCarlo.h"
+#include "ThreadPool.h"
+#include "RunningStats.h"
+#include "SobolSequence.h"
+#include "BrownianBridge.h"
+#include "SimdMath.h"
+#include "PayoffKernels.h"
+#include "PathCache.h"
+#include "PathStore.h"
+#include "Instrumentation.h"
+#include "DistributedMonteCarlo.h"
+#include "LocalVolatilityModel.h"
+#include "HestonModel.h"
 #include <cmath>
 #include <random>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
 
 using namespace std;
 
-double MonteCarlo::price(const Option& option, const BlackScholesModel& model, int nbSimulations) {
-    mt19937 gen(random_device{}());
-    vector<double> path; // Ce vecteur recevra les prix simuls
-    double payoffSum = 0.0;
-    // Calcul du Pas de Temps (Discrtisation) : une anne contient 252 jours de trading
-    int steps = 252 * option.getMaturity();
+MonteCarloSettings::MonteCarloSettings(): seed(((unsigned long long)random_device{}() << 32) | random_device{}()), nbThreads(0),
+    generator(PSEUDO_RANDOM), nbReplicas(16), confidenceLevel(0.95), antithetic(false), controlVariate(false), momentMatching(false) {}
+
+MonteCarloSettings::MonteCarloSettings(unsigned long long s, int threads): seed(s), nbThreads(threads),
+    generator(PSEUDO_RANDOM), nbReplicas(16), confidenceLevel(0.95), antithetic(false), controlVariate(false), momentMatching(false) {}
+
+// Calcul du Pas de Temps (Discrtisation) : une anne contient 252 jours de trading
+int MonteCarlo::stepsFor(double T) {
+    int steps = 252 * T;
     if(steps < 1) steps = 1; //Ceci permet d'viter la dvision par 0
+    return steps;
+}
+
+double MonteCarlo::price(const Option& option, const BlackScholesModel& model, int nbSimulations) {
+    return price(option, model, nbSimulations, MonteCarloSettings());
+}
+
+double MonteCarlo::price(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    return estimate(option, model, nbSimulations, settings).price;
+}
+
+// ------------------------------------------ NOYAUX DE PAYOFF ------------------------------------------
+
+// Payoffs y[i] (et variables de contrle c[i] si demand, 0 sinon) des n premires trajectoires (n <= PathBatch::LANES)
+typedef void (*BatchPayoffs)(const Option& option, const PathSummaries& paths, int n, bool withControl, double* y, double* c);
+
+template <class Kernel>
+SIMD_CLONES
+static void kernelLoop(const Kernel& kernel, const BatchView& view, int n, bool withControl, double* __restrict y, double* __restrict c) {
+    for (int i = 0; i < n; ++i) y[i] = kernel.payoff(view, i); // Appel rsolu  la compilation : inlin et vectoris
+    if (withControl)
+        for (int i = 0; i < n; ++i) c[i] = kernel.control(view, i);
+    else
+        for (int i = 0; i < n; ++i) c[i] = 0.0;
+}
+
+template <class Kernel>
+static void kernelPayoffs(const Option& option, const PathSummaries& paths, int n, bool withControl, double* y, double* c) {
+    double geometric[PathBatch::LANES];
+    BatchView view = { paths.last, paths.sum, paths.maxSpot, paths.minSpot, geometric, 1.0 / paths.count };
+    int used = Kernel::TRACKING | (withControl ? Kernel::CONTROL_TRACKING : 0);
+    if (used & PathBatch::LOG_SUM) {
+        for (int i = 0; i < n; ++i) geometric[i] = paths.logSum[i] * view.invCount;
+        SimdMath::exp(geometric, geometric, n);
+    }
+    kernelLoop(Kernel(option.getStrike()), view, n, withControl, y, c);
+}
+
+// Options CUSTOM : appel virtuel pour chaque trajectoire
+static void virtualPayoffs(const Option& option, const PathSummaries& paths, int n, bool withControl, double* y, double* c) {
+    for (int i = 0; i < n; ++i) {
+        PathAccumulator acc = paths.path(i);
+        y[i] = option.payoff(acc); // Grce au polymorphisme, "option.payoff" appelle la bonne formule de l'option
+        c[i] = withControl ? option.controlPayoff(acc) : 0.0;
+    }
+}
+
+// Noyau choisi une fois par appel de Monte Carlo : l'valuation d'un paquet et ce que le gnrateur doit suivre
+struct PayoffKernel {
+    BatchPayoffs evaluate;
+    int tracking;
+    int controlTracking; // Suivi en plus seulement avec la variable de contrle
+
+    int trackingFor(bool withControl) const {
+        return withControl ? tracking | controlTracking : tracking;
+    }
+    bool readsLogs(bool withControl) const { // Le payoff (ou son contrle) lit la somme des log-prix
+        return (trackingFor(withControl) & PathBatch::LOG_SUM) != 0;
+    }
+};
+
+template <class Kernel>
+static PayoffKernel makeKernel() {
+    PayoffKernel kernel = { &kernelPayoffs<Kernel>, Kernel::TRACKING, Kernel::CONTROL_TRACKING };
+    return kernel;
+}
+
+static PayoffKernel selectKernel(const Option& option) {
+    switch (option.payoffType()) {
+    case Option::EUROPEAN_CALL: return makeKernel<EuropeanCallKernel>();
+    case Option::EUROPEAN_PUT:  return makeKernel<EuropeanPutKernel>();
+    case Option::ASIAN_CALL:    return makeKernel<AsianCallKernel>();
+    case Option::ASIAN_PUT:     return makeKernel<AsianPutKernel>();
+    case Option::GEOMETRIC_ASIAN_CALL: return makeKernel<GeometricAsianCallKernel>();
+    case Option::GEOMETRIC_ASIAN_PUT:  return makeKernel<GeometricAsianPutKernel>();
+    case Option::DIGITAL_CALL:  return makeKernel<DigitalCallKernel>();
+    case Option::DIGITAL_PUT:   return makeKernel<DigitalPutKernel>();
+    case Option::LOOKBACK_CALL: return makeKernel<LookbackCallKernel>();
+    case Option::LOOKBACK_PUT:  return makeKernel<LookbackPutKernel>();
+    default: {
+        PayoffKernel kernel = { &virtualPayoffs, PathBatch::ALL, 0 };
+        return kernel;
+    }
+    }
+}
+
+// Rsum d'une trajectoire complte (variable de contrle des options non "streamables") ; log-prix seulement si withLogs
+static PathAccumulator summarize(const vector<double>& path, bool withLogs) {
+    PathAccumulator acc;
+    acc.start(path[0], withLogs);
+    for (size_t i = 1; i < path.size(); ++i) acc.add(path[i]);
+    return acc;
+}
+
+// Ajoute les n payoffs d'un paquet (et leurs contrles) aux statistiques, selon l'unit indpendante de l'chantillonnage
+static void addBatch(EstimatorStats& stats, const double* y, const double* c, int n, const MonteCarloSettings& settings) {
+    for (int i = 0; i < n; ++i) stats.paths.add(y[i]);
+    if (settings.momentMatching) { // Le paquet entier forme une unit
+        double ySum = 0.0, cSum = 0.0;
+        for (int i = 0; i < n; ++i) { ySum += y[i]; cSum += c[i]; }
+        stats.addUnit(ySum / n, cSum / n);
+    } else if (settings.antithetic) { // La trajectoire i + n/2 est l'antithtique de i
+        for (int i = 0; i < n / 2; ++i) stats.addUnit(0.5 * (y[i] + y[i + n / 2]), 0.5 * (c[i] + c[i + n / 2]));
+    } else {
+        for (int i = 0; i < n; ++i) stats.addUnit(y[i], c[i]);
+    }
+}
+
+// Variable de contrle selon le modle. BlackScholesModel : celle de l'option (Option::controlPayoff, prix ferm
+// Option::controlPrice). HestonModel : l'europenne de mme strike et de mme sens, payoff sur S_T et prix par
+// HestonModel::europeanPrice (les prix ferms des contrles de Option supposent une volatilit constante).
+static bool vanillaControl(const BlackScholesModel&) { return false; }
+static bool vanillaControl(const LocalVolatilityModel&) { return false; } // Contrles dsactivs (estimateMany)
+static bool vanillaControl(const HestonModel&) { return true; }
+
+// Sens de l'europenne de contrle : +1 call, -1 put ; 0 pour les europennes elles-mmes (le contrle serait le
+// payoff) et les options CUSTOM
+static int vanillaSense(const Option& option) {
+    switch (option.payoffType()) {
+    case Option::ASIAN_CALL: case Option::GEOMETRIC_ASIAN_CALL: case Option::DIGITAL_CALL: case Option::LOOKBACK_CALL: return 1;
+    case Option::ASIAN_PUT: case Option::GEOMETRIC_ASIAN_PUT: case Option::DIGITAL_PUT: case Option::LOOKBACK_PUT: return -1;
+    default: return 0;
+    }
+}
+
+static bool allStreamable(const vector<const Option*>& options) {
+    for (size_t k = 0; k < options.size(); ++k)
+        if (!options[k]->isStreamable()) return false;
+    return true;
+}
+
+// Simule les blocs [firstBlock, lastBlock) (trajectoires < nbSimulations) une seule fois pour toutes les options (mme maturit) :
+// statistiques de l'option k sur le bloc b dans blockStats[(b - firstBlock) * nbOptions + k].
+// Options "streamables" seulement : stored != nullptr relit les trajectoires d'un jeu dj simul au lieu de les gnrer,
+// record != nullptr garde celles qui sont simules (la trajectoire i dans la case i).
+// Model : BlackScholesModel, LocalVolatilityModel ou HestonModel (mmes gnrateurs generatePath / generateBatch).
+template <class Model>
+static void simulateBlockStats(const vector<const Option*>& options, const Model& model, const MonteCarloSettings& settings,
+                               int firstBlock, int lastBlock, int nbSimulations, vector<EstimatorStats>& blockStats,
+                               const PathSet* stored = nullptr, PathSet* record = nullptr) {
+    const int BLOCK_SIZE = MonteCarlo::BLOCK_SIZE;
+    int nbOptions = options.size();
+    double T = options[0]->getMaturity();
+    int steps = MonteCarlo::stepsFor(T);
+    int nbBlocks = lastBlock - firstBlock;
+    int sampling = (settings.antithetic ? BlackScholesModel::ANTITHETIC : 0) |
+                   (settings.momentMatching ? BlackScholesModel::MOMENT_MATCHING : 0);
+    bool streamable = allStreamable(options);
 
-    for (int i = 0; i < nbSimulations; ++i) {
-        model.generatePath(option.getMaturity(), steps, path, gen); // Gnrer une trajectoire de prix
-        payoffSum += option.payoff(path); // Grce au polymorphisme, "option.payoff" appelle la bonne formule de l'option
+    // Noyaux choisis une fois ; le paquet suit l'union de ce dont les payoffs ont besoin
+    vector<PayoffKernel> kernels(nbOptions);
+    vector<char> useControl(nbOptions), optionControl(nbOptions); // optionControl : contrle calcul par le noyau de l'option
+    vector<int> senses(nbOptions);
+    bool vanilla = vanillaControl(model);
+    int tracking = PathBatch::LAST;
+    for (int k = 0; k < nbOptions; ++k) {
+        kernels[k] = selectKernel(*options[k]);
+        senses[k] = vanillaSense(*options[k]);
+        useControl[k] = settings.controlVariate && (vanilla ? senses[k] != 0 : options[k]->hasControlVariate());
+        optionControl[k] = useControl[k] && !vanilla;
+        tracking |= kernels[k].trackingFor(optionControl[k]);
     }
-    // Moyenne = Somme / N
+    blockStats.assign((size_t)nbBlocks * nbOptions, EstimatorStats()); // Une case par (bloc, option) : aucun partage entre threads
+
+    ThreadPool::run(nbBlocks, settings.nbThreads, [&](int task) {
+        int b = firstBlock + task;
+        RandomStream gen(settings.seed, b); // Flux propre au bloc
+        int first = b * BLOCK_SIZE;
+        int last = min(first + BLOCK_SIZE, nbSimulations);
+        EstimatorStats* stats = &blockStats[(size_t)task * nbOptions];
+        if (streamable) {
+            // Pas de vecteur : les trajectoires du bloc avancent par paquets (SoA) et seul leur rsum est gard
+            PathBatch batch;
+            batch.tracking = record ? (int)PathBatch::ALL : tracking; // Un jeu gard doit servir  tous les payoffs
+            double y[PathBatch::LANES], c[PathBatch::LANES];
+            for (int start = first; start < last; start += PathBatch::LANES) {
+                int n = min(PathBatch::LANES, last - start);
+                if (settings.antithetic) n += n & 1; // Paires compltes
+                PathSummaries paths;
+                if (stored) {
+                    paths = stored->at(start);
+                } else {
+                    if (n != batch.size) batch.resize(n);
+                    model.generateBatch(T, steps, batch, gen, sampling); // Tirages et volution mesurs par le modle
+                    PRICER_TIMER(timer);
+                    if (record) record->store(start, batch, n);
+                    PRICER_LAP(timer, STORAGE);
+                    paths = batch.summaries();
+                }
+                PRICER_COUNT(paths, n);
+                PRICER_TIMER(timer);
+                for (int k = 0; k < nbOptions; ++k) { // Mme paquet pour tous les payoffs
+                    kernels[k].evaluate(*options[k], paths, n, optionControl[k], y, c);
+                    if (useControl[k] && vanilla) {
+                        double K = options[k]->getStrike(), sense = senses[k];
+                        for (int i = 0; i < n; ++i) c[i] = max(sense * (paths.last[i] - K), 0.0);
+                    }
+                    PRICER_LAP(timer, PAYOFF);
+                    addBatch(stats[k], y, c, n, settings);
+                    PRICER_LAP(timer, REDUCTION);
+                }
+            }
+        } else {
+            vector<double> path; // Ce vecteur recevra les prix simuls
+            for (int i = first; i < last; ++i) {
+                model.generatePath(T, steps, path, gen); // Gnrer une trajectoire de prix
+                PRICER_COUNT(paths, 1);
+                PRICER_TIMER(timer);
+                for (int k = 0; k < nbOptions; ++k) {
+                    double y = options[k]->payoff(path); // Grce au polymorphisme, "payoff" appelle la bonne formule de l'option
+                    double control = !useControl[k] ? 0.0
+                                   : vanilla ? max(senses[k] * (path.back() - options[k]->getStrike()), 0.0)
+                                   : options[k]->controlPayoff(summarize(path, kernels[k].readsLogs(true)));
+                    PRICER_LAP(timer, PAYOFF);
+                    stats[k].paths.add(y);
+                    stats[k].addUnit(y, control);
+                    PRICER_LAP(timer, REDUCTION);
+                }
+            }
+        }
+    });
+}
+
+// Idem, et fusionne les statistiques de l'option k dans totals[k], dans l'ordre des blocs :
+// des appels successifs sur des plages contigus donnent exactement le mme total qu'un seul appel.
+template <class Model>
+static void simulateBlocks(const vector<const Option*>& options, const Model& model, const MonteCarloSettings& settings,
+                           int firstBlock, int lastBlock, int nbSimulations, vector<EstimatorStats>& totals,
+                           const PathSet* stored = nullptr, PathSet* record = nullptr) {
+    vector<EstimatorStats> blockStats;
+    simulateBlockStats(options, model, settings, firstBlock, lastBlock, nbSimulations, blockStats, stored, record);
+    // Fusion dans l'ordre des blocs : l'ordre des additions ne dpend pas des threads
+    for (size_t b = 0; b < blockStats.size() / options.size(); ++b)
+        for (size_t k = 0; k < options.size(); ++k) totals[k].merge(blockStats[b * options.size() + k]);
+}
+
+// Prix actualis et erreur standard  partir des statistiques d'une option ; controlMean : esprance non actualise
+// de la variable de contrle (utilise si useControl)
+static MonteCarloResult finishUnits(const EstimatorStats& total, double discount, bool useControl, double controlMean) {
+    double mean = total.payoff.mean;
+    double unitVariance = total.payoff.variance();
+    long long nbUnits = total.payoff.count;
+    if (useControl) {
+        // Y - beta * (C - E[C]) avec beta = Cov(Y, C) / Var(C) : la variance rsiduelle est Var(Y) - beta * Cov(Y, C)
+        double covariance = total.coM2 / (nbUnits - 1);
+        double beta = covariance / total.control.variance();
+        mean -= beta * (total.control.mean - controlMean);
+        unitVariance -= beta * covariance;
+    }
+
     // Actualisation = Moyenne * exp(-r * T)
-    return exp(-model.getRate() * option.getMaturity()) * payoffSum / nbSimulations;
+    MonteCarloResult result;
+    result.price = discount * mean;
+    result.stdError = nbUnits > 0 ? discount * sqrt(unitVariance / nbUnits) : 0.0;
+    result.nbPaths = total.paths.count;
+    result.varianceReduction = unitVariance > 0.0 ? total.paths.variance() * nbUnits / (unitVariance * total.paths.count) : 1.0;
+    return result;
+}
+
+// steps : nombre de pas des trajectoires (prix de la variable de contrle)
+static MonteCarloResult finishEstimate(const Option& option, const BlackScholesModel& model, const MonteCarloSettings& settings,
+                                       const EstimatorStats& total, int steps) {
+    bool useControl = settings.controlVariate && option.hasControlVariate() && total.control.variance() > 0.0;
+    double discount = exp(-model.getRate() * option.getMaturity());
+    return finishUnits(total, discount, useControl, useControl ? option.controlPrice(model, steps) / discount : 0.0);
+}
+
+// Sans variable de contrle (estimateMany les dsactive) ; actualisation par la courbe de taux
+static MonteCarloResult finishEstimate(const Option& option, const LocalVolatilityModel& model, const MonteCarloSettings&,
+                                       const EstimatorStats& total, int) {
+    return finishUnits(total, model.discountFactor(option.getMaturity()), false, 0.0);
+}
+
+// Contrle : l'europenne de mme sens, au prix de la fonction caractristique. Celle-ci est le prix exact du modle
+// continu : le biais de discrtisation du schma sur l'europenne (faible avec QE) passe dans l'estimateur, pondr par beta.
+static MonteCarloResult finishEstimate(const Option& option, const HestonModel& model, const MonteCarloSettings& settings,
+                                       const EstimatorStats& total, int) {
+    int sense = vanillaSense(option);
+    bool useControl = settings.controlVariate && sense != 0 && total.control.variance() > 0.0;
+    double discount = exp(-model.getRate() * option.getMaturity());
+    double controlMean = useControl ? model.europeanPrice(option.getStrike(), option.getMaturity(), sense > 0) / discount : 0.0;
+    return finishUnits(total, discount, useControl, controlMean);
+}
+
+template <class Model>
+static vector<MonteCarloResult> estimatePseudoRandom(const vector<const Option*>& options, const Model& model, int nbSimulations,
+                                                     const MonteCarloSettings& settings, const PathSet* stored = nullptr, PathSet* record = nullptr) {
+    int nbBlocks = (nbSimulations + MonteCarlo::BLOCK_SIZE - 1) / MonteCarlo::BLOCK_SIZE;
+    vector<EstimatorStats> totals(options.size());
+    simulateBlocks(options, model, settings, 0, nbBlocks, nbSimulations, totals, stored, record);
+    vector<MonteCarloResult> results;
+    for (size_t k = 0; k < options.size(); ++k) results.push_back(finishEstimate(*options[k], model, settings, totals[k], MonteCarlo::stepsFor(options[k]->getMaturity())));
+    return results;
+}
+
+// Mme contrat que simulateBlocks pour stored / record (la trajectoire i de la rplication r dans la case r * pointsPerReplica + i)
+static vector<MonteCarloResult> estimateQuasiRandom(const vector<const Option*>& options, const BlackScholesModel& model, int nbSimulations,
+                                                    const MonteCarloSettings& settings, const PathSet* stored = nullptr, PathSet* record = nullptr) {
+    const int BLOCK_SIZE = MonteCarlo::BLOCK_SIZE;
+    const int LANES = 64; // Trajectoires construites ensemble par le pont brownien
+    int nbOptions = options.size();
+    double T = options[0]->getMaturity();
+    int steps = MonteCarlo::stepsFor(T);
+    int nbReplicas = max(1, settings.nbReplicas);
+    int pointsPerReplica = (nbSimulations + nbReplicas - 1) / nbReplicas;
+    int blocksPerReplica = (pointsPerReplica + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int nbTasks = nbReplicas * blocksPerReplica;
+    bool streamable = allStreamable(options);
+
+    // Nombres directeurs brouills : calculs une fois par rplication, puis copis par chaque bloc
+    vector<SobolSequence> sequences;
+    if (!stored)
+        for (int r = 0; r < nbReplicas; ++r) sequences.push_back(SobolSequence(steps, settings.seed, r));
+
+    vector<PayoffKernel> kernels(nbOptions);
+    int tracking = PathBatch::LAST;
+    for (int k = 0; k < nbOptions; ++k) {
+        kernels[k] = selectKernel(*options[k]);
+        tracking |= kernels[k].trackingFor(false);
+    }
+    vector<RunningStats> blockStats((size_t)nbTasks * nbOptions);
+
+    ThreadPool::run(nbTasks, settings.nbThreads, [&](int task) {
+        int r = task / blocksPerReplica;
+        int first = (task % blocksPerReplica) * BLOCK_SIZE;
+        int last = min(first + BLOCK_SIZE, pointsPerReplica);
+        size_t offset = (size_t)r * pointsPerReplica;
+        RunningStats* stats = &blockStats[(size_t)task * nbOptions];
+        double y[LANES], c[LANES];
+        if (stored) { // Trajectoires dj simules : seuls les payoffs sont valus
+            for (int start = first; start < last; start += LANES) {
+                int n = min(LANES, last - start);
+                PathSummaries paths = stored->at(offset + start);
+                PRICER_COUNT(paths, n);
+                PRICER_TIMER(timer);
+                for (int k = 0; k < nbOptions; ++k) {
+                    kernels[k].evaluate(*options[k], paths, n, false, y, c);
+                    PRICER_LAP(timer, PAYOFF);
+                    for (int i = 0; i < n; ++i) stats[k].add(y[i]);
+                    PRICER_LAP(timer, REDUCTION);
+                }
+            }
+            return;
+        }
+
+        SobolSequence sobol = sequences[r];
+        sobol.skipTo(first);
+        BrownianBridge bridge(steps, T);
+        vector<double> u((size_t)steps * LANES), z((size_t)steps * LANES), increments((size_t)steps * LANES);
+        PathBatch batch;
+        batch.tracking = record ? (int)PathBatch::ALL : tracking;
+        vector<double> path;
+
+        for (int start = first; start < last; start += LANES) {
+            int n = min(LANES, last - start);
+            if (n != batch.size) batch.resize(n);
+            int stride = batch.size; // Arrondi pair : la dernire colonne ventuelle reste  zro
+            PRICER_TIMER(timer);
+            for (int i = 0; i < n; ++i) sobol.next(&u[(size_t)i * steps]);
+            SimdMath::inverseNormalCdf(u.data(), z.data(), n * steps); // Un seul appel pour tout le paquet
+            for (int i = 0; i < n; ++i) bridge.build(&z[(size_t)i * steps], &increments[i], stride);
+            PRICER_LAP(timer, RANDOM);
+            PRICER_COUNT(draws, n * steps);
+            PRICER_COUNT(paths, n);
+            if (streamable) {
+                model.generateBatch(T, steps, batch, increments.data());
+                PRICER_RESTART(timer);
+                if (record) record->store(offset + start, batch, n);
+                PRICER_LAP(timer, STORAGE);
+                PathSummaries paths = batch.summaries();
+                for (int k = 0; k < nbOptions; ++k) {
+                    kernels[k].evaluate(*options[k], paths, n, false, y, c);
+                    PRICER_LAP(timer, PAYOFF);
+                    for (int i = 0; i < n; ++i) stats[k].add(y[i]);
+                    PRICER_LAP(timer, REDUCTION);
+                }
+            } else {
+                for (int i = 0; i < n; ++i) {
+                    model.generatePath(T, steps, path, &increments[i], stride);
+                    PRICER_RESTART(timer);
+                    for (int k = 0; k < nbOptions; ++k) stats[k].add(options[k]->payoff(path));
+                    PRICER_LAP(timer, PAYOFF);
+                }
+            }
+        }
+    });
+
+    double discount = exp(-model.getRate() * T);
+    vector<MonteCarloResult> results;
+    for (int k = 0; k < nbOptions; ++k) {
+        // Moyenne de chaque rplication, puis statistiques sur les rplications (indpendantes par construction)
+        RunningStats replicaMeans, paths;
+        for (int r = 0; r < nbReplicas; ++r) {
+            RunningStats replica;
+            for (int b = 0; b < blocksPerReplica; ++b) replica.merge(blockStats[(size_t)(r * blocksPerReplica + b) * nbOptions + k]);
+            replicaMeans.add(replica.mean);
+            paths.merge(replica);
+        }
+
+        MonteCarloResult result;
+        result.price = discount * replicaMeans.mean;
+        result.stdError = nbReplicas > 1 ? discount * replicaMeans.stdError() : 0.0;
+        result.nbPaths = (long long)nbReplicas * pointsPerReplica;
+        double estimatorVariance = replicaMeans.variance() / nbReplicas;
+        result.varianceReduction = nbReplicas > 1 && estimatorVariance > 0.0 ? paths.variance() / (estimatorVariance * result.nbPaths) : 1.0;
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Quantile de la loi normale pour un intervalle bilatral au niveau "level" (1.96 pour 95 %)
+static double confidenceQuantile(double level) {
+    double u = 0.5 + 0.5 * level, z;
+    SimdMath::inverseNormalCdf(&u, &z, 1);
+    return z;
+}
+
+static void setConfidence(MonteCarloResult& result, double level) {
+    result.halfWidth = confidenceQuantile(level) * result.stdError;
+    result.confidenceLow = result.price - result.halfWidth;
+    result.confidenceHigh = result.price + result.halfWidth;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+MonteCarloResult MonteCarlo::estimate(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimate");
+    return estimateMany(vector<const Option*>(1, &option), model, nbSimulations, settings)[0];
+}
+
+static void checkSameMaturity(const vector<const Option*>& options) {
+    for (size_t k = 1; k < options.size(); ++k)
+        if (options[k]->getMaturity() != options[0]->getMaturity())
+            throw invalid_argument("MonteCarlo::estimateMany : toutes les options doivent avoir la meme maturite");
+}
+
+static void finishResults(vector<MonteCarloResult>& results, const MonteCarloSettings& settings, chrono::steady_clock::time_point start) {
+    double elapsed = secondsSince(start);
+    for (size_t k = 0; k < results.size(); ++k) {
+        setConfidence(results[k], settings.confidenceLevel);
+        results[k].converged = true;
+        results[k].elapsedSeconds = elapsed;
+    }
+}
+
+vector<MonteCarloResult> MonteCarlo::estimateMany(const vector<const Option*>& options, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    if (options.empty()) return vector<MonteCarloResult>();
+    checkSameMaturity(options);
+    if (!settings.workers.empty()) return DistributedMonteCarlo::estimateMany(options, model, nbSimulations, settings);
+    PRICER_PROFILE_CALL("MonteCarlo::estimateMany");
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<MonteCarloResult> results = settings.generator == MonteCarloSettings::QUASI_RANDOM
+        ? estimateQuasiRandom(options, model, nbSimulations, settings)
+        : estimatePseudoRandom(options, model, nbSimulations, settings);
+    finishResults(results, settings, start);
+    return results;
+}
+
+MonteCarloResult MonteCarlo::estimate(const Option& option, const LocalVolatilityModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimate (LocalVolatilityModel)");
+    return estimateMany(vector<const Option*>(1, &option), model, nbSimulations, settings)[0];
+}
+
+// estimateMany des modles simuls en PSEUDO_RANDOM seulement, sans calcul rparti (LocalVolatilityModel, HestonModel)
+template <class Model>
+static vector<MonteCarloResult> estimateModel(const vector<const Option*>& options, const Model& model, int nbSimulations,
+                                              const MonteCarloSettings& settings) {
+    if (options.empty()) return vector<MonteCarloResult>();
+    checkSameMaturity(options);
+    if (settings.generator != MonteCarloSettings::PSEUDO_RANDOM)
+        throw invalid_argument("MonteCarlo::estimateMany : ce modele se simule en PSEUDO_RANDOM seulement");
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<MonteCarloResult> results = estimatePseudoRandom(options, model, nbSimulations, settings);
+    finishResults(results, settings, start);
+    return results;
+}
+
+vector<MonteCarloResult> MonteCarlo::estimateMany(const vector<const Option*>& options, const LocalVolatilityModel& model, int nbSimulations,
+                                                  const MonteCarloSettings& settings) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimateMany (LocalVolatilityModel)");
+    MonteCarloSettings local = settings;
+    local.controlVariate = false; // Les prix des contrles supposent r et sigma constants
+    return estimateModel(options, model, nbSimulations, local);
+}
+
+double MonteCarlo::price(const Option& option, const HestonModel& model, int nbSimulations) {
+    return price(option, model, nbSimulations, MonteCarloSettings());
+}
+
+double MonteCarlo::price(const Option& option, const HestonModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    return estimate(option, model, nbSimulations, settings).price;
+}
+
+MonteCarloResult MonteCarlo::estimate(const Option& option, const HestonModel& model, int nbSimulations, const MonteCarloSettings& settings) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimate (HestonModel)");
+    return estimateMany(vector<const Option*>(1, &option), model, nbSimulations, settings)[0];
+}
+
+vector<MonteCarloResult> MonteCarlo::estimateMany(const vector<const Option*>& options, const HestonModel& model, int nbSimulations,
+                                                  const MonteCarloSettings& settings) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimateMany (HestonModel)");
+    return estimateModel(options, model, nbSimulations, settings);
+}
+
+vector<EstimatorStats> MonteCarlo::blockStatistics(const vector<const Option*>& options, const BlackScholesModel& model, int nbSimulations,
+                                                   const MonteCarloSettings& settings, int firstBlock, int lastBlock) {
+    vector<EstimatorStats> blockStats;
+    if (options.empty()) return blockStats;
+    checkSameMaturity(options);
+    int nbBlocks = (nbSimulations + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if (firstBlock < 0 || lastBlock > nbBlocks || firstBlock >= lastBlock)
+        throw invalid_argument("MonteCarlo::blockStatistics : plage de blocs invalide");
+    simulateBlockStats(options, model, settings, firstBlock, lastBlock, nbSimulations, blockStats);
+    return blockStats;
+}
+
+vector<MonteCarloResult> MonteCarlo::resultsFromBlocks(const vector<const Option*>& options, const BlackScholesModel& model,
+                                                       const MonteCarloSettings& settings, const vector<EstimatorStats>& blockStats) {
+    size_t nbOptions = options.size();
+    vector<EstimatorStats> totals(nbOptions);
+    for (size_t b = 0; b < blockStats.size() / max(nbOptions, (size_t)1); ++b)
+        for (size_t k = 0; k < nbOptions; ++k) totals[k].merge(blockStats[b * nbOptions + k]);
+    vector<MonteCarloResult> results;
+    for (size_t k = 0; k < nbOptions; ++k) {
+        results.push_back(finishEstimate(*options[k], model, settings, totals[k], stepsFor(options[k]->getMaturity())));
+        setConfidence(results[k], settings.confidenceLevel);
+        results[k].converged = true;
+        results[k].elapsedSeconds = 0.0;
+    }
+    return results;
+}
+
+MonteCarloResult MonteCarlo::estimate(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings, PathCache& cache) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimate (cache)");
+    return estimateMany(vector<const Option*>(1, &option), model, nbSimulations, settings, cache)[0];
+}
+
+vector<MonteCarloResult> MonteCarlo::estimateMany(const vector<const Option*>& options, const BlackScholesModel& model, int nbSimulations,
+                                                  const MonteCarloSettings& settings, PathCache& cache) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimateMany (cache)");
+    if (options.empty() || !allStreamable(options)) return estimateMany(options, model, nbSimulations, settings); // Trajectoires compltes : pas de cache
+    checkSameMaturity(options);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool quasi = settings.generator == MonteCarloSettings::QUASI_RANDOM;
+    double T = options[0]->getMaturity();
+    int steps = stepsFor(T);
+    int nbReplicas = quasi ? max(1, settings.nbReplicas) : 0;
+    int sampling = quasi ? 0 : (settings.antithetic ? BlackScholesModel::ANTITHETIC : 0) |
+                               (settings.momentMatching ? BlackScholesModel::MOMENT_MATCHING : 0);
+    PathCache::Key key(model.getSpot(), model.getRate(), model.getVolatility(), T, steps, nbSimulations,
+                       settings.seed, (int)settings.generator, nbReplicas, sampling);
+
+    shared_ptr<const PathSet> stored = cache.find(key);
+    shared_ptr<PathSet> record;
+    if (!stored) {
+        // Cases ncessaires : une par point de chaque rplication (QMC), une de plus qu'il n'y a de trajectoires sinon
+        // (la dernire paire antithtique peut dborder d'une trajectoire)
+        size_t nbPaths = quasi ? (size_t)nbReplicas * ((nbSimulations + nbReplicas - 1) / nbReplicas) : (size_t)nbSimulations + 1;
+        if (5 * nbPaths * sizeof(double) <= cache.getMaxBytes()) record = make_shared<PathSet>(nbPaths, steps + 1);
+    }
+
+    vector<MonteCarloResult> results = quasi
+        ? estimateQuasiRandom(options, model, nbSimulations, settings, stored.get(), record.get())
+        : estimatePseudoRandom(options, model, nbSimulations, settings, stored.get(), record.get());
+    if (record) cache.insert(key, record);
+    finishResults(results, settings, start);
+    return results;
+}
+
+MonteCarloResult MonteCarlo::estimateToTolerance(const Option& option, const BlackScholesModel& model, double tolerance,
+                                                 const MonteCarloSettings& settings, double maxSeconds, int maxSimulations) {
+    PRICER_PROFILE_CALL("MonteCarlo::estimateToTolerance");
+    const int FIRST_WAVE = 16; // Blocs de la premire vague : assez de trajectoires pour estimer la variance
+    bool quasi = settings.generator == MonteCarloSettings::QUASI_RANDOM;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int maxBlocks = max(1, maxSimulations / BLOCK_SIZE);
+
+    vector<const Option*> options(1, &option);
+    vector<EstimatorStats> totals(1); // PSEUDO_RANDOM : statistiques cumules des vagues prcdentes
+    MonteCarloResult result;
+    int nbBlocks = 0, target = min(FIRST_WAVE, maxBlocks);
+    while (true) {
+        chrono::steady_clock::time_point waveStart = chrono::steady_clock::now();
+        if (quasi) {
+            result = estimateQuasiRandom(options, model, target * BLOCK_SIZE, settings)[0];
+        } else {
+            simulateBlocks(options, model, settings, nbBlocks, target, target * BLOCK_SIZE, totals);
+            result = finishEstimate(option, model, settings, totals[0], stepsFor(option.getMaturity()));
+        }
+        double secondsPerBlock = secondsSince(waveStart) / (quasi ? target : target - nbBlocks);
+        nbBlocks = target;
+        setConfidence(result, settings.confidenceLevel);
+        result.converged = result.halfWidth <= tolerance;
+        if (result.converged || nbBlocks >= maxBlocks) break;
+
+        // Blocs ncessaires d'aprs la variance observe (+10 %), au plus le double, et dans ce que le temps restant permet
+        double ratio = result.halfWidth / tolerance;
+        double needed = min(1.1 * nbBlocks * ratio * ratio, 2.0 * nbBlocks);
+        double affordable = (maxSeconds - secondsSince(start)) / secondsPerBlock + (quasi ? 0 : nbBlocks);
+        target = (int)min((double)maxBlocks, ceil(min(needed, affordable)));
+        if (target <= nbBlocks) break; // Budget de temps puis
+    }
+    result.elapsedSeconds = secondsSince(start);
+    return result;
+}
+
+// ------------------------------------- TRAJECTOIRES ENREGISTRES -------------------------------------
+
+double MonteCarlo::price(const Option& option, const PathStore& store, const MonteCarloSettings& settings) {
+    return estimate(option, store, settings).price;
+}
+
+// Rsums de n trajectoires enregistres (count prix chacune) dans un paquet ; log-prix seulement si withLogs
+static void summarizeStored(const PathStore& store, long long first, int n, int count, bool withLogs, PathBatch& batch, double* logs) {
+    for (int i = 0; i < n; ++i) {
+        const double* p = store.path(first + i); // Lecture directe dans la projection du fichier
+        double sum = 0.0, maxSpot = p[0], minSpot = p[0];
+        for (int j = 0; j < count; ++j) {
+            sum += p[j];
+            maxSpot = p[j] > maxSpot ? p[j] : maxSpot;
+            minSpot = p[j] < minSpot ? p[j] : minSpot;
+        }
+        batch.last[i] = p[count - 1];
+        batch.sum[i] = sum;
+        batch.maxSpot[i] = maxSpot;
+        batch.minSpot[i] = minSpot;
+        if (withLogs) {
+            SimdMath::log(p, logs, count);
+            double logSum = 0.0;
+            for (int j = 0; j < count; ++j) logSum += logs[j];
+            batch.logSum[i] = logSum;
+        }
+    }
+    batch.count = count;
+}
+
+MonteCarloResult MonteCarlo::estimate(const Option& option, const PathStore& store, const MonteCarloSettings& settings) {
+    if (fabs(option.getMaturity() - store.getMaturity()) > 1e-12)
+        throw invalid_argument("MonteCarlo::estimate : la maturite de l'option differe de celle des trajectoires enregistrees");
+
+    PRICER_PROFILE_CALL("MonteCarlo::estimate (PathStore)");
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    BlackScholesModel model = store.getModel();
+    int steps = store.getSteps();
+    long long nbPaths = store.getNbPaths();
+    MonteCarloSettings replay = settings; // Trajectoires dj tires : chacune est une unit indpendante
+    replay.antithetic = false;
+    replay.momentMatching = false;
+
+    PayoffKernel kernel = selectKernel(option);
+    bool useControl = settings.controlVariate && option.hasControlVariate();
+    bool withLogs = kernel.readsLogs(useControl);
+    bool streamable = option.isStreamable();
+    int nbBlocks = (int)((nbPaths + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    vector<EstimatorStats> blockStats(nbBlocks);
+
+    ThreadPool::run(nbBlocks, settings.nbThreads, [&](int b) {
+        long long first = (long long)b * BLOCK_SIZE;
+        long long last = min(first + BLOCK_SIZE, nbPaths);
+        EstimatorStats& stats = blockStats[b];
+        if (streamable) {
+            PathBatch batch;
+            vector<double> logs(withLogs ? steps + 1 : 0);
+            double y[PathBatch::LANES], c[PathBatch::LANES];
+            for (long long begin = first; begin < last; begin += PathBatch::LANES) {
+                int n = (int)min((long long)PathBatch::LANES, last - begin);
+                PRICER_TIMER(timer);
+                summarizeStored(store, begin, n, steps + 1, withLogs, batch, logs.data());
+                PRICER_LAP(timer, STORAGE);
+                kernel.evaluate(option, batch.summaries(), n, useControl, y, c);
+                PRICER_LAP(timer, PAYOFF);
+                addBatch(stats, y, c, n, replay);
+                PRICER_LAP(timer, REDUCTION);
+                PRICER_COUNT(paths, n);
+            }
+        } else {
+            vector<double> path(steps + 1); // L'interface "vector" impose une copie de la trajectoire
+            for (long long i = first; i < last; ++i) {
+                PRICER_TIMER(timer);
+                const double* p = store.path(i);
+                copy(p, p + steps + 1, path.begin());
+                PRICER_LAP(timer, STORAGE);
+                double y = option.payoff(path);
+                double control = useControl ? option.controlPayoff(summarize(path, withLogs)) : 0.0;
+                PRICER_LAP(timer, PAYOFF);
+                stats.paths.add(y);
+                stats.addUnit(y, control);
+                PRICER_LAP(timer, REDUCTION);
+                PRICER_COUNT(paths, 1);
+            }
+        }
+    });
+
+    EstimatorStats total;
+    for (int b = 0; b < nbBlocks; ++b) total.merge(blockStats[b]);
+    MonteCarloResult result = finishEstimate(option, model, replay, total, steps);
+    setConfidence(result, settings.confidenceLevel);
+    result.converged = true;
+    result.elapsedSeconds = secondsSince(start);
+    return result;
 }
 
 // -------------------------------------------LES GRECS---------------------------------------------------
 
-// On ne drive pas les formules. On choque les paramtres
+// On ne drive pas les formules. On choque les paramtres.
+// Les prix choqus utilisent la mme graine que le prix de base (nombres alatoires communs) :
+// le bruit Monte Carlo se compense dans la diffrence.
 
 double MonteCarlo::delta(const Option& option, const BlackScholesModel& model, int nbSimulations, double epsilon) {
     // Formule : (Prix(S+e) - Prix(S-e)) / 2e
     BlackScholesModel up(model.getSpot() + epsilon, model.getRate(), model.getVolatility());
     BlackScholesModel down(model.getSpot() - epsilon, model.getRate(), model.getVolatility());
+    MonteCarloSettings settings;
 
-    double pUp = price(option, up, nbSimulations);
-    double pDown = price(option, down, nbSimulations);
+    double pUp = price(option, up, nbSimulations, settings);
+    double pDown = price(option, down, nbSimulations, settings);
 
     return (pUp - pDown) / (2.0 * epsilon);
 }
@@ -41,9 +758,11 @@ double MonteCarlo::gamma(const Option& option, const BlackScholesModel& model, i
     BlackScholesModel up(model.getSpot() + epsilon, model.getRate(), model.getVolatility());
     BlackScholesModel down(model.getSpot() - epsilon, model.getRate(), model.getVolatility());
 
-    double pUp = price(option, up, nbSimulations);
-    double pBase = price(option, model, nbSimulations);
-    double pDown = price(option, down, nbSimulations);
+    MonteCarloSettings settings;
+
+    double pUp = price(option, up, nbSimulations, settings);
+    double pBase = price(option, model, nbSimulations, settings);
+    double pDown = price(option, down, nbSimulations, settings);
 
     return (pUp - 2.0 * pBase + pDown) / (epsilon * epsilon);
 }
@@ -53,8 +772,243 @@ double MonteCarlo::vega(const Option& option, const BlackScholesModel& model, in
     BlackScholesModel volUp(model.getSpot(), model.getRate(), model.getVolatility() + epsilon);
     BlackScholesModel volBase(model.getSpot(), model.getRate(), model.getVolatility());
 
-    double pUp = price(option, volUp, nbSimulations);
-    double pBase = price(option, volBase, nbSimulations);
+    MonteCarloSettings settings;
+
+    double pUp = price(option, volUp, nbSimulations, settings);
+    double pBase = price(option, volBase, nbSimulations, settings);
 
     return (pUp - pBase) / epsilon;
 }
+
+// ------------------------------------- PRIX + GRECS EN UNE PASSE -------------------------------------
+
+// Estimateurs par trajectoire : les 4 quantits sont calcules sur les mmes tirages
+struct GreeksStats {
+    RunningStats price, delta, gamma, vega;
+
+    void add(double p, double pUp, double pDown, double pVolUp, double pVolDown, double h, double volStep) {
+        price.add(p);
+        delta.add((pUp - pDown) / (2.0 * h));
+        gamma.add((pUp - 2.0 * p + pDown) / (h * h));
+        vega.add((pVolUp - pVolDown) / volStep);
+    }
+
+    void merge(const GreeksStats& other) {
+        price.merge(other.price); delta.merge(other.delta); gamma.merge(other.gamma); vega.merge(other.vega);
+    }
+};
+
+GreeksResult MonteCarlo::priceWithGreeks(const Option& option, const BlackScholesModel& model, int nbSimulations, const MonteCarloSettings& settings, double spotShift, double volShift) {
+    PRICER_PROFILE_CALL("MonteCarlo::priceWithGreeks");
+    double T = option.getMaturity();
+    int steps = stepsFor(T);
+    double S0 = model.getSpot();
+    double h = spotShift * S0; // Choc absolu sur le spot
+
+    // Volatilits des 3 scnarios : base, choc haut, choc bas (diffrence avant si sigma - e <= 0)
+    double vols[3] = { model.getVolatility(), model.getVolatility() + volShift, model.getVolatility() - volShift };
+    if (vols[2] <= 0.0) vols[2] = vols[0];
+    double volStep = vols[1] - vols[2];
+
+    int nbBlocks = (nbSimulations + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    vector<GreeksStats> blockStats(nbBlocks);
+
+    ThreadPool::run(nbBlocks, settings.nbThreads, [&](int b) {
+        RandomStream gen(settings.seed, b);
+        int first = b * BLOCK_SIZE;
+        int last = min(first + BLOCK_SIZE, nbSimulations);
+        GreeksStats& stats = blockStats[b];
+
+        if (option.isStreamable()) {
+            // Une seule gnration de normales pour les 3 volatilits ; les chocs de spot sont une homothtie du rsum
+            PathBatch batches[3];
+            for (int start = first; start < last; start += PathBatch::LANES) {
+                int n = min(PathBatch::LANES, last - start);
+                if (n != batches[0].size) for (int k = 0; k < 3; ++k) batches[k].resize(n);
+                model.generateBatch(T, steps, batches, vols, 3, gen);
+                PRICER_COUNT(paths, n);
+                PRICER_PHASE(PAYOFF);
+                for (int i = 0; i < n; ++i) {
+                    PathAccumulator acc = batches[0].path(i);
+                    stats.add(option.payoff(acc),
+                              option.payoff(acc.scaled((S0 + h) / S0)),
+                              option.payoff(acc.scaled((S0 - h) / S0)),
+                              option.payoff(batches[1].path(i)),
+                              option.payoff(batches[2].path(i)), h, volStep);
+                }
+            }
+        } else {
+            // Trajectoire complte : on rejoue le mme flux alatoire pour les volatilits choques
+            BlackScholesModel volUp(S0, model.getRate(), vols[1]);
+            BlackScholesModel volDown(S0, model.getRate(), vols[2]);
+            vector<double> path, pathUp, pathDown, pathVolUp, pathVolDown;
+            for (int i = first; i < last; ++i) {
+                RandomStream replay = gen;
+                model.generatePath(T, steps, path, gen);
+                RandomStream genUp = replay;
+                volUp.generatePath(T, steps, pathVolUp, genUp);
+                RandomStream genDown = replay;
+                volDown.generatePath(T, steps, pathVolDown, genDown);
+                PRICER_COUNT(paths, 1);
+
+                PRICER_PHASE(PAYOFF);
+                pathUp.resize(path.size());
+                pathDown.resize(path.size());
+                for (size_t j = 0; j < path.size(); ++j) {
+                    pathUp[j] = path[j] * (S0 + h) / S0;
+                    pathDown[j] = path[j] * (S0 - h) / S0;
+                }
+                stats.add(option.payoff(path), option.payoff(pathUp), option.payoff(pathDown),
+                          option.payoff(pathVolUp), option.payoff(pathVolDown), h, volStep);
+            }
+        }
+    });
+
+    // Fusion dans l'ordre des blocs (rsultat reproductible)
+    GreeksStats total;
+    for (int b = 0; b < nbBlocks; ++b) total.merge(blockStats[b]);
+
+    double discount = exp(-model.getRate() * T);
+    GreeksResult result;
+    result.price = discount * total.price.mean;
+    result.delta = discount * total.delta.mean;
+    result.gamma = discount * total.gamma.mean;
+    result.vega = discount * total.vega.mean;
+    result.priceStdError = discount * total.price.stdError();
+    result.deltaStdError = discount * total.delta.stdError();
+    result.gammaStdError = discount * total.gamma.stdError();
+    result.vegaStdError = discount * total.vega.stdError();
+    return result;
+}
+
+// ------------------------------------------ GRILLE DE SCNARIOS ------------------------------------------
+
+// Rsums des trajectoires d'un paquet dont chaque prix est multipli par "factor" (seules les grandeurs suivies)
+struct ScaledSummaries {
+    double last[PathBatch::LANES], sum[PathBatch::LANES], maxSpot[PathBatch::LANES], minSpot[PathBatch::LANES], logSum[PathBatch::LANES];
+
+    PathSummaries scale(const PathSummaries& paths, int tracking, double factor, int n) {
+        for (int i = 0; i < n; ++i) last[i] = paths.last[i] * factor;
+        if (tracking & PathBatch::SUM)
+            for (int i = 0; i < n; ++i) sum[i] = paths.sum[i] * factor;
+        if (tracking & PathBatch::MAX_SPOT)
+            for (int i = 0; i < n; ++i) maxSpot[i] = paths.maxSpot[i] * factor;
+        if (tracking & PathBatch::MIN_SPOT)
+            for (int i = 0; i < n; ++i) minSpot[i] = paths.minSpot[i] * factor;
+        if (tracking & PathBatch::LOG_SUM) {
+            double shift = paths.count * log(factor); // Chaque log-prix est dcal de log(factor)
+            for (int i = 0; i < n; ++i) logSum[i] = paths.logSum[i] + shift;
+        }
+        PathSummaries view = { last, sum, maxSpot, minSpot, logSum, paths.count };
+        return view;
+    }
+};
+
+// Ajoute les n valeurs d'un paquet aux statistiques, par unit indpendante de l'chantillonnage (comme addBatch)
+static void addUnits(RunningStats& stats, const double* x, int n, const MonteCarloSettings& settings) {
+    if (settings.momentMatching) {
+        double total = 0.0;
+        for (int i = 0; i < n; ++i) total += x[i];
+        stats.add(total / n);
+    } else if (settings.antithetic) {
+        for (int i = 0; i < n / 2; ++i) stats.add(0.5 * (x[i] + x[i + n / 2]));
+    } else {
+        for (int i = 0; i < n; ++i) stats.add(x[i]);
+    }
+}
+
+struct ScenarioStats {
+    RunningStats price, delta, gamma;
+
+    void merge(const ScenarioStats& other) {
+        price.merge(other.price); delta.merge(other.delta); gamma.merge(other.gamma);
+    }
+};
+
+vector<ScenarioResult> MonteCarlo::scenarioGrid(const Option& option, const BlackScholesModel& model, const vector<ScenarioShock>& shocks,
+                                                int nbSimulations, const MonteCarloSettings& settings, double spotShift) {
+    PRICER_PROFILE_CALL("MonteCarlo::scenarioGrid");
+    if (!option.isStreamable()) throw invalid_argument("MonteCarlo::scenarioGrid : option non streamable");
+    if (settings.generator != MonteCarloSettings::PSEUDO_RANDOM) throw invalid_argument("MonteCarlo::scenarioGrid : generateur pseudo-aleatoire seulement");
+    if (!(spotShift > 0.0 && spotShift < 1.0)) throw invalid_argument("MonteCarlo::scenarioGrid : choc de spot invalide");
+    double T = option.getMaturity();
+    int steps = stepsFor(T);
+    int nbCells = shocks.size();
+    if (nbCells == 0) return vector<ScenarioResult>();
+
+    // Volatilits distinctes de la grille : une volution chacune, sur les mmes normales
+    vector<double> vols;
+    vector<int> volIndex(nbCells);
+    for (int k = 0; k < nbCells; ++k) {
+        double vol = model.getVolatility() + shocks[k].volShock;
+        if (!(vol > 0.0) || !(1.0 + shocks[k].spotShock > 0.0))
+            throw invalid_argument("MonteCarlo::scenarioGrid : le choc donne un spot ou une volatilite negatif");
+        size_t v = find(vols.begin(), vols.end(), vol) - vols.begin();
+        if (v == vols.size()) vols.push_back(vol);
+        volIndex[k] = (int)v;
+    }
+    int nbVols = vols.size();
+    int sampling = (settings.antithetic ? BlackScholesModel::ANTITHETIC : 0) |
+                   (settings.momentMatching ? BlackScholesModel::MOMENT_MATCHING : 0);
+    PayoffKernel kernel = selectKernel(option);
+    int tracking = kernel.trackingFor(false);
+
+    int nbBlocks = (nbSimulations + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    vector<ScenarioStats> blockStats((size_t)nbBlocks * nbCells); // Une case par (bloc, scnario)
+
+    ThreadPool::run(nbBlocks, settings.nbThreads, [&](int b) {
+        RandomStream gen(settings.seed, b);
+        int first = b * BLOCK_SIZE;
+        int last = min(first + BLOCK_SIZE, nbSimulations);
+        ScenarioStats* stats = &blockStats[(size_t)b * nbCells];
+        vector<PathBatch> batches(nbVols);
+        for (int v = 0; v < nbVols; ++v) batches[v].tracking = tracking;
+        ScaledSummaries scaled;
+        double y[PathBatch::LANES], yUp[PathBatch::LANES], yDown[PathBatch::LANES], c[PathBatch::LANES];
+        double delta[PathBatch::LANES], gamma[PathBatch::LANES];
+
+        for (int start = first; start < last; start += PathBatch::LANES) {
+            int n = min(PathBatch::LANES, last - start);
+            if (settings.antithetic) n += n & 1;
+            if (n != batches[0].size) for (int v = 0; v < nbVols; ++v) batches[v].resize(n);
+            model.generateBatch(T, steps, batches.data(), vols.data(), nbVols, gen, sampling);
+            PRICER_COUNT(paths, n);
+            PRICER_TIMER(timer);
+            for (int k = 0; k < nbCells; ++k) {
+                PathSummaries paths = batches[volIndex[k]].summaries();
+                double factor = 1.0 + shocks[k].spotShock;
+                double h = spotShift * model.getSpot() * factor;
+                kernel.evaluate(option, scaled.scale(paths, tracking, factor, n), n, false, y, c);
+                kernel.evaluate(option, scaled.scale(paths, tracking, factor * (1.0 + spotShift), n), n, false, yUp, c);
+                kernel.evaluate(option, scaled.scale(paths, tracking, factor * (1.0 - spotShift), n), n, false, yDown, c);
+                for (int i = 0; i < n; ++i) {
+                    delta[i] = (yUp[i] - yDown[i]) / (2.0 * h);
+                    gamma[i] = (yUp[i] - 2.0 * y[i] + yDown[i]) / (h * h);
+                }
+                PRICER_LAP(timer, PAYOFF);
+                addUnits(stats[k].price, y, n, settings);
+                addUnits(stats[k].delta, delta, n, settings);
+                addUnits(stats[k].gamma, gamma, n, settings);
+                PRICER_LAP(timer, REDUCTION);
+            }
+        }
+    });
+
+    // Fusion dans l'ordre des blocs (rsultat reproductible)
+    vector<ScenarioResult> results(nbCells);
+    double discount = exp(-model.getRate() * T);
+    for (int k = 0; k < nbCells; ++k) {
+        ScenarioStats total;
+        for (int b = 0; b < nbBlocks; ++b) total.merge(blockStats[(size_t)b * nbCells + k]);
+        ScenarioResult& result = results[k];
+        result.spot = model.getSpot() * (1.0 + shocks[k].spotShock);
+        result.volatility = vols[volIndex[k]];
+        result.price = discount * total.price.mean;
+        result.delta = discount * total.delta.mean;
+        result.gamma = discount * total.gamma.mean;
+        result.priceStdError = discount * total.price.stdError();
+        result.deltaStdError = discount * total.delta.stdError();
+        result.gammaStdError = discount * total.gamma.stdError();
+    }
+    return results;
+}
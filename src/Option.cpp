@@ -1,12 +1,15 @@
 #include "Option.h"
+#include "BlackScholesModel.h"
 #include <iostream>
+#include <stdexcept>
+#include <typeinfo>
 using namespace std;
 
 // ==========================================
 // 1. CLASSE MRE (OPTION)
 // ==========================================
 
-Option::Option(double T, double K, string n): maturity(T), strike(K), name(n) {} //Constructeur
+Option::Option(double T, double K, const char* n): maturity(T), strike(K), name(n) {} //Constructeur
 
 Option::~Option() {} // Destructeur
 
@@ -18,10 +21,50 @@ double Option::getStrike() const {
     return strike;
 }
 
-string Option::getName() const {
+const char* Option::getName() const {
     return name;
 }
 
+bool Option::isStreamable() const {
+    return false; // Par dfaut, le payoff a besoin de toute la trajectoire
+}
+
+double Option::payoff(const PathAccumulator&) const {
+    throw logic_error(string(name) + " : pas de payoff streaming, utiliser payoff(path)");
+}
+
+// Vrai si l'option est exactement de la classe prdfinie, faux pour une classe qui en drive : elle a pu redfinir
+// payoff(), que le noyau compil, le payoff streaming, la formule ferme et la variable de contrle hrits ignoreraient
+// (lu une fois par appel de Monte Carlo ou par contrat, typeid ne cote rien)
+template <class Builtin>
+static bool isExactly(const Option& option) {
+    return typeid(option) == typeid(Builtin);
+}
+
+Option::PayoffType Option::payoffType() const {
+    return CUSTOM;
+}
+
+bool Option::hasControlVariate() const {
+    return false;
+}
+
+double Option::controlPayoff(const PathAccumulator&) const {
+    throw logic_error(string(name) + " : pas de variable de controle");
+}
+
+double Option::controlPrice(const BlackScholesModel&, int) const {
+    throw logic_error(string(name) + " : pas de variable de controle");
+}
+
+Option::ClosedForm Option::closedForm() const {
+    return NO_CLOSED_FORM;
+}
+
+double Option::closedFormPrice(const BlackScholesModel&, int) const {
+    throw logic_error(string(name) + " : pas de formule fermee");
+}
+
 // ==========================================
 // 2. OPTIONS EUROPENNES
 // ==========================================
@@ -35,6 +78,20 @@ double CallEuropeen::payoff(const vector<double>& path) const {
     return max(path.back() - strike, 0.0);
 }
 
+bool CallEuropeen::isStreamable() const { return isExactly<CallEuropeen>(*this); }
+
+double CallEuropeen::payoff(const PathAccumulator& acc) const {
+    return max(acc.last - strike, 0.0);
+}
+
+Option::PayoffType CallEuropeen::payoffType() const { return isExactly<CallEuropeen>(*this) ? EUROPEAN_CALL : CUSTOM; }
+
+Option::ClosedForm CallEuropeen::closedForm() const { return isExactly<CallEuropeen>(*this) ? EXACT : NO_CLOSED_FORM; }
+
+double CallEuropeen::closedFormPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, true);
+}
+
 // --- Put Europeen ---
 PutEuropeen::PutEuropeen(double T, double K): Option(T, K, "Put Europeen") {}
 
@@ -43,6 +100,20 @@ double PutEuropeen::payoff(const vector<double>& path) const {
     return max(strike - path.back(), 0.0);
 }
 
+bool PutEuropeen::isStreamable() const { return isExactly<PutEuropeen>(*this); }
+
+double PutEuropeen::payoff(const PathAccumulator& acc) const {
+    return max(strike - acc.last, 0.0);
+}
+
+Option::PayoffType PutEuropeen::payoffType() const { return isExactly<PutEuropeen>(*this) ? EUROPEAN_PUT : CUSTOM; }
+
+Option::ClosedForm PutEuropeen::closedForm() const { return isExactly<PutEuropeen>(*this) ? EXACT : NO_CLOSED_FORM; }
+
+double PutEuropeen::closedFormPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, false);
+}
+
 // ==========================================
 // 3. OPTIONS ASIATIQUES
 // ==========================================
@@ -62,6 +133,26 @@ double CallAsiatique::payoff(const vector<double>& path) const {
     return max(average - strike, 0.0);
 }
 
+bool CallAsiatique::isStreamable() const { return isExactly<CallAsiatique>(*this); }
+
+double CallAsiatique::payoff(const PathAccumulator& acc) const {
+    // La somme a t accumule pendant la simulation
+    return max(acc.average() - strike, 0.0);
+}
+
+Option::PayoffType CallAsiatique::payoffType() const { return isExactly<CallAsiatique>(*this) ? ASIAN_CALL : CUSTOM; }
+
+// Contrle : le Call sur moyenne gomtrique (toujours <= arithmtique, corrlation proche de 1)
+bool CallAsiatique::hasControlVariate() const { return isExactly<CallAsiatique>(*this); }
+
+double CallAsiatique::controlPayoff(const PathAccumulator& acc) const {
+    return max(acc.geometricAverage() - strike, 0.0);
+}
+
+double CallAsiatique::controlPrice(const BlackScholesModel& model, int steps) const {
+    return model.geometricAsianPrice(strike, maturity, steps, true);
+}
+
 // --- Put Asiatique ---
 PutAsiatique::PutAsiatique(double T, double K): Option(T, K, "Put Asiatique") {}
 
@@ -75,6 +166,71 @@ double PutAsiatique::payoff(const vector<double>& path) const {
     return max(strike - average, 0.0);
 }
 
+bool PutAsiatique::isStreamable() const { return isExactly<PutAsiatique>(*this); }
+
+double PutAsiatique::payoff(const PathAccumulator& acc) const {
+    return max(strike - acc.average(), 0.0);
+}
+
+Option::PayoffType PutAsiatique::payoffType() const { return isExactly<PutAsiatique>(*this) ? ASIAN_PUT : CUSTOM; }
+
+bool PutAsiatique::hasControlVariate() const { return isExactly<PutAsiatique>(*this); }
+
+double PutAsiatique::controlPayoff(const PathAccumulator& acc) const {
+    return max(strike - acc.geometricAverage(), 0.0);
+}
+
+double PutAsiatique::controlPrice(const BlackScholesModel& model, int steps) const {
+    return model.geometricAsianPrice(strike, maturity, steps, false);
+}
+
+// --- Call Asiatique Gomtrique ---
+CallAsiatiqueGeometrique::CallAsiatiqueGeometrique(double T, double K): Option(T, K, "Call Asiatique Geometrique") {}
+
+double CallAsiatiqueGeometrique::payoff(const vector<double>& path) const {
+    // Moyenne gomtrique = exp(moyenne des log-prix)
+    double logSum = 0.0;
+    for (size_t i = 0; i < path.size(); ++i) logSum += log(path[i]);
+    return max(exp(logSum / path.size()) - strike, 0.0);
+}
+
+bool CallAsiatiqueGeometrique::isStreamable() const { return isExactly<CallAsiatiqueGeometrique>(*this); }
+
+double CallAsiatiqueGeometrique::payoff(const PathAccumulator& acc) const {
+    return max(acc.geometricAverage() - strike, 0.0);
+}
+
+Option::PayoffType CallAsiatiqueGeometrique::payoffType() const { return isExactly<CallAsiatiqueGeometrique>(*this) ? GEOMETRIC_ASIAN_CALL : CUSTOM; }
+
+Option::ClosedForm CallAsiatiqueGeometrique::closedForm() const { return isExactly<CallAsiatiqueGeometrique>(*this) ? EXACT : NO_CLOSED_FORM; }
+
+double CallAsiatiqueGeometrique::closedFormPrice(const BlackScholesModel& model, int steps) const {
+    return model.geometricAsianPrice(strike, maturity, steps, true);
+}
+
+// --- Put Asiatique Gomtrique ---
+PutAsiatiqueGeometrique::PutAsiatiqueGeometrique(double T, double K): Option(T, K, "Put Asiatique Geometrique") {}
+
+double PutAsiatiqueGeometrique::payoff(const vector<double>& path) const {
+    double logSum = 0.0;
+    for (size_t i = 0; i < path.size(); ++i) logSum += log(path[i]);
+    return max(strike - exp(logSum / path.size()), 0.0);
+}
+
+bool PutAsiatiqueGeometrique::isStreamable() const { return isExactly<PutAsiatiqueGeometrique>(*this); }
+
+double PutAsiatiqueGeometrique::payoff(const PathAccumulator& acc) const {
+    return max(strike - acc.geometricAverage(), 0.0);
+}
+
+Option::PayoffType PutAsiatiqueGeometrique::payoffType() const { return isExactly<PutAsiatiqueGeometrique>(*this) ? GEOMETRIC_ASIAN_PUT : CUSTOM; }
+
+Option::ClosedForm PutAsiatiqueGeometrique::closedForm() const { return isExactly<PutAsiatiqueGeometrique>(*this) ? EXACT : NO_CLOSED_FORM; }
+
+double PutAsiatiqueGeometrique::closedFormPrice(const BlackScholesModel& model, int steps) const {
+    return model.geometricAsianPrice(strike, maturity, steps, false);
+}
+
 // ==========================================
 // 4. OPTIONS DIGITALES
 // ==========================================
@@ -91,6 +247,25 @@ double CallDigital::payoff(const vector<double>& path) const {
         return 0.0; // Perdu.
     }
 }
+
+bool CallDigital::isStreamable() const { return isExactly<CallDigital>(*this); }
+
+double CallDigital::payoff(const PathAccumulator& acc) const {
+    return acc.last > strike ? 1.0 : 0.0;
+}
+
+Option::PayoffType CallDigital::payoffType() const { return isExactly<CallDigital>(*this) ? DIGITAL_CALL : CUSTOM; }
+
+// Contrle : le Call Europen de mme strike (formule de Black-Scholes)
+bool CallDigital::hasControlVariate() const { return isExactly<CallDigital>(*this); }
+
+double CallDigital::controlPayoff(const PathAccumulator& acc) const {
+    return max(acc.last - strike, 0.0);
+}
+
+double CallDigital::controlPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, true);
+}
 // --- Put Digital ---
 PutDigital::PutDigital(double T, double K): Option(T, K, "Put Digital") {}
 
@@ -104,6 +279,24 @@ double PutDigital::payoff(const vector<double>& path) const {
     }
 }
 
+bool PutDigital::isStreamable() const { return isExactly<PutDigital>(*this); }
+
+double PutDigital::payoff(const PathAccumulator& acc) const {
+    return acc.last < strike ? 1.0 : 0.0;
+}
+
+Option::PayoffType PutDigital::payoffType() const { return isExactly<PutDigital>(*this) ? DIGITAL_PUT : CUSTOM; }
+
+bool PutDigital::hasControlVariate() const { return isExactly<PutDigital>(*this); }
+
+double PutDigital::controlPayoff(const PathAccumulator& acc) const {
+    return max(strike - acc.last, 0.0);
+}
+
+double PutDigital::controlPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, false);
+}
+
 // ==========================================
 // 5. OPTIONS LOOKBACK
 // ==========================================
@@ -119,6 +312,33 @@ double CallLookback::payoff(const vector<double>& path) const {
     return max(maxSpot - strike, 0.0);
 }
 
+bool CallLookback::isStreamable() const { return isExactly<CallLookback>(*this); }
+
+double CallLookback::payoff(const PathAccumulator& acc) const {
+    // Le maximum a t suivi pendant la simulation
+    return max(acc.maxSpot - strike, 0.0);
+}
+
+Option::PayoffType CallLookback::payoffType() const { return isExactly<CallLookback>(*this) ? LOOKBACK_CALL : CUSTOM; }
+
+// Contrle : le Call Europen de mme strike, qui ne voit que S_T
+bool CallLookback::hasControlVariate() const { return isExactly<CallLookback>(*this); }
+
+double CallLookback::controlPayoff(const PathAccumulator& acc) const {
+    return max(acc.last - strike, 0.0);
+}
+
+double CallLookback::controlPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, true);
+}
+
+// Extremum relev aux dates de la trajectoire : formule continue corrige (Broadie-Glasserman-Kou)
+Option::ClosedForm CallLookback::closedForm() const { return isExactly<CallLookback>(*this) ? CORRECTED : NO_CLOSED_FORM; }
+
+double CallLookback::closedFormPrice(const BlackScholesModel& model, int steps) const {
+    return model.lookbackPrice(strike, maturity, steps, true);
+}
+
 // --- Put Lookback  ---
 PutLookback::PutLookback(double T, double K): Option(T, K, "Put Lookback") {}
 
@@ -130,3 +350,27 @@ double PutLookback::payoff(const vector<double>& path) const {
     return max(strike - minSpot, 0.0);
 }
 
+bool PutLookback::isStreamable() const { return isExactly<PutLookback>(*this); }
+
+double PutLookback::payoff(const PathAccumulator& acc) const {
+    return max(strike - acc.minSpot, 0.0);
+}
+
+Option::PayoffType PutLookback::payoffType() const { return isExactly<PutLookback>(*this) ? LOOKBACK_PUT : CUSTOM; }
+
+bool PutLookback::hasControlVariate() const { return isExactly<PutLookback>(*this); }
+
+double PutLookback::controlPayoff(const PathAccumulator& acc) const {
+    return max(strike - acc.last, 0.0);
+}
+
+double PutLookback::controlPrice(const BlackScholesModel& model, int) const {
+    return model.bsPrice(strike, maturity, false);
+}
+
+Option::ClosedForm PutLookback::closedForm() const { return isExactly<PutLookback>(*this) ? CORRECTED : NO_CLOSED_FORM; }
+
+double PutLookback::closedFormPrice(const BlackScholesModel& model, int steps) const {
+    return model.lookbackPrice(strike, maturity, steps, false);
+}
+
@@ -0,0 +1,86 @@
+#include "PathBatch.h"
+#include "BlackScholesModel.h"
+#include "RandomStream.h"
+#include "SimdMath.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void PathBatch::start(double spot, int steps) {
+    fill(last.begin(), last.end(), spot);
+    fill(sum.begin(), sum.end(), spot);
+    fill(maxSpot.begin(), maxSpot.end(), spot);
+    fill(minSpot.begin(), minSpot.end(), spot);
+    fill(logLast.begin(), logLast.end(), log(spot));
+    fill(logSum.begin(), logSum.end(), log(spot));
+    count = steps + 1;
+}
+
+void PathBatch::drawNormals(RandomStream& gen, int sampling) {
+    int n = size;
+    uint32_t* b = bits.data();
+    double* z = normals.data();
+    if (sampling & BlackScholesModel::ANTITHETIC) {
+        int half = n / 2;
+        int drawn = half + (half & 1); // Box-Muller : nombre pair de normales
+        gen.fill(b, drawn);
+        SimdMath::normals(b, z, drawn);
+        PRICER_COUNT(draws, drawn);
+        for (int i = 0; i < half; ++i) z[half + i] = -z[i];
+    } else {
+        gen.fill(b, n);              // n entiers alatoires (Philox)
+        SimdMath::normals(b, z, n);  // n normales N(0,1) (Box-Muller)
+        PRICER_COUNT(draws, n);
+    }
+    if (sampling & BlackScholesModel::MOMENT_MATCHING) {
+        double mean = 0.0, m2 = 0.0;
+        for (int i = 0; i < n; ++i) mean += z[i];
+        mean /= n;
+        for (int i = 0; i < n; ++i) m2 += (z[i] - mean) * (z[i] - mean);
+        double scale = 1.0 / sqrt(m2 / n);
+        for (int i = 0; i < n; ++i) z[i] = (z[i] - mean) * scale;
+    }
+}
+
+// log S(t+dt) = log S(t) + exposant : la moyenne gomtrique ne cote aucun appel  log
+SIMD_CLONES
+void PathBatch::advanceLogs(const double* exponent) {
+    if (!(tracking & LOG_SUM)) return;
+    int n = size;
+    double* logs = logLast.data();
+    double* logTotal = logSum.data();
+    for (int i = 0; i < n; ++i) {
+        logs[i] += exponent[i];
+        logTotal[i] += logs[i];
+    }
+}
+
+SIMD_CLONES
+void PathBatch::advance(const double* growth) {
+    // S(t+dt) = S(t) * growth, puis mise  jour du rsum de chaque trajectoire
+    int n = size;
+    double* S = last.data();
+    double* total = sum.data();
+    double* highest = maxSpot.data();
+    double* lowest = minSpot.data();
+    if ((tracking & ~LOG_SUM) == (ALL & ~LOG_SUM)) { // Rsum complet : une seule boucle
+        for (int i = 0; i < n; ++i) {
+            double next = S[i] * growth[i];
+            S[i] = next;
+            total[i] += next;
+            highest[i] = next > highest[i] ? next : highest[i];
+            lowest[i] = next < lowest[i] ? next : lowest[i];
+        }
+        return;
+    }
+    // Sinon, une boucle par grandeur suivie : les autres ne cotent rien
+    for (int i = 0; i < n; ++i) S[i] *= growth[i];
+    if (tracking & SUM)
+        for (int i = 0; i < n; ++i) total[i] += S[i];
+    if (tracking & MAX_SPOT)
+        for (int i = 0; i < n; ++i) highest[i] = S[i] > highest[i] ? S[i] : highest[i];
+    if (tracking & MIN_SPOT)
+        for (int i = 0; i < n; ++i) lowest[i] = S[i] < lowest[i] ? S[i] : lowest[i];
+}
@@ -0,0 +1,87 @@
+#include "PathCache.h"
+#include <algorithm>
+
+using namespace std;
+
+PathSet::PathSet(size_t nbPaths, int c): count(c), last(nbPaths), sum(nbPaths), maxSpot(nbPaths), minSpot(nbPaths), logSum(nbPaths) {}
+
+PathSummaries PathSet::at(size_t first) const {
+    PathSummaries view = { &last[first], &sum[first], &maxSpot[first], &minSpot[first], &logSum[first], count };
+    return view;
+}
+
+void PathSet::store(size_t first, const PathBatch& batch, int n) {
+    copy(batch.last.begin(), batch.last.begin() + n, last.begin() + first);
+    copy(batch.sum.begin(), batch.sum.begin() + n, sum.begin() + first);
+    copy(batch.maxSpot.begin(), batch.maxSpot.begin() + n, maxSpot.begin() + first);
+    copy(batch.minSpot.begin(), batch.minSpot.begin() + n, minSpot.begin() + first);
+    copy(batch.logSum.begin(), batch.logSum.begin() + n, logSum.begin() + first);
+}
+
+size_t PathSet::bytes() const {
+    return 5 * last.size() * sizeof(double);
+}
+
+PathCache::PathCache(size_t m): maxBytes(m), memoryUsage(0), hits(0), misses(0) {}
+
+shared_ptr<const PathSet> PathCache::find(const Key& key) {
+    lock_guard<std::mutex> lock(access);
+    map<Key, Entries::iterator>::iterator found = index.find(key);
+    if (found == index.end()) {
+        ++misses;
+        return shared_ptr<const PathSet>();
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, found->second); // Devient le plus rcent (l'itrateur reste valide)
+    return found->second->second;
+}
+
+void PathCache::insert(const Key& key, const shared_ptr<const PathSet>& paths) {
+    size_t bytes = paths->bytes();
+    if (bytes > maxBytes) return;
+
+    lock_guard<std::mutex> lock(access);
+    map<Key, Entries::iterator>::iterator found = index.find(key);
+    if (found != index.end()) { // Simul entre-temps par un autre appel : on garde la version la plus rcente
+        memoryUsage -= found->second->second->bytes();
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    while (memoryUsage + bytes > maxBytes) { // viction des moins rcemment utiliss
+        memoryUsage -= entries.back().second->bytes();
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.push_front(make_pair(key, paths));
+    index[key] = entries.begin();
+    memoryUsage += bytes;
+}
+
+void PathCache::clear() {
+    lock_guard<std::mutex> lock(access);
+    entries.clear();
+    index.clear();
+    memoryUsage = 0;
+}
+
+size_t PathCache::getMaxBytes() const { return maxBytes; }
+
+size_t PathCache::getMemoryUsage() const {
+    lock_guard<std::mutex> lock(access);
+    return memoryUsage;
+}
+
+size_t PathCache::size() const {
+    lock_guard<std::mutex> lock(access);
+    return entries.size();
+}
+
+long long PathCache::getHits() const {
+    lock_guard<std::mutex> lock(access);
+    return hits;
+}
+
+long long PathCache::getMisses() const {
+    lock_guard<std::mutex> lock(access);
+    return misses;
+}
@@ -0,0 +1,153 @@
+#include "PathStore.h"
+#include "MonteCarlo.h"
+#include "ThreadPool.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PATH_STORE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char MAGIC[8] = { 'O', 'P', 'P', 'A', 'T', 'H', 'S', '1' };
+static const long long ALIGNMENT = 64 / sizeof(double); // Une trajectoire commence sur une ligne de cache
+
+// En-tte du fichier (64 octets : les donnes qui suivent restent alignes)
+struct PathStoreHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t steps;
+    double spot, rate, volatility, maturity;
+    int64_t nbPaths;
+    uint64_t seed;
+};
+static_assert(sizeof(PathStoreHeader) == 64, "en-tete de PathStore : 64 octets");
+
+static long long strideFor(int steps) {
+    return (steps + 1 + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void PathStore::write(const string& file, const BlackScholesModel& model, double T, int steps, long long nbPaths,
+                      unsigned long long seed, int nbThreads) {
+    PRICER_PROFILE_CALL("PathStore::write");
+    const int BLOCK_SIZE = MonteCarlo::BLOCK_SIZE;
+    ofstream out(file.c_str(), ios::binary | ios::trunc);
+    if (!out) throw runtime_error("PathStore : impossible de creer " + file);
+
+    PathStoreHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.steps = steps;
+    header.spot = model.getSpot();
+    header.rate = model.getRate();
+    header.volatility = model.getVolatility();
+    header.maturity = T;
+    header.nbPaths = nbPaths;
+    header.seed = seed;
+    out.write((const char*)&header, sizeof(header));
+
+    // Les blocs sont simuls en parallle par vagues, puis crits dans l'ordre : la mmoire utilise reste borne
+    long long stride = strideFor(steps);
+    long long nbBlocks = (nbPaths + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int wave = max(16, 2 * (nbThreads > 0 ? nbThreads : ThreadPool::hardwareThreads()));
+    vector<double> buffer;
+    for (long long firstBlock = 0; firstBlock < nbBlocks; firstBlock += wave) {
+        int nbWaveBlocks = (int)min((long long)wave, nbBlocks - firstBlock);
+        long long firstPath = firstBlock * BLOCK_SIZE;
+        long long wavePaths = min(nbPaths, firstPath + (long long)nbWaveBlocks * BLOCK_SIZE) - firstPath;
+        buffer.assign((size_t)(wavePaths * stride), 0.0); // Complment de chaque trajectoire  zro
+
+        ThreadPool::run(nbWaveBlocks, nbThreads, [&](int task) {
+            long long b = firstBlock + task;
+            RandomStream gen(seed, b); // Flux propre au bloc
+            vector<double> path;
+            long long first = b * BLOCK_SIZE;
+            long long last = min(first + BLOCK_SIZE, nbPaths);
+            for (long long i = first; i < last; ++i) {
+                model.generatePath(T, steps, path, gen);
+                PRICER_PHASE(STORAGE);
+                copy(path.begin(), path.end(), buffer.begin() + (i - firstPath) * stride);
+                PRICER_COUNT(paths, 1);
+            }
+        });
+        PRICER_PHASE(STORAGE);
+        out.write((const char*)buffer.data(), buffer.size() * sizeof(double));
+    }
+    if (!out.flush()) throw runtime_error("PathStore : erreur d'ecriture dans " + file);
+}
+
+PathStore::PathStore(const string& file): data(nullptr), mapping(nullptr), mappingSize(0) {
+#ifdef PATH_STORE_MMAP
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("PathStore : impossible d'ouvrir " + file);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(PathStoreHeader)) {
+        close(fd);
+        throw runtime_error("PathStore : fichier invalide ou tronque : " + file);
+    }
+    mappingSize = (size_t)info.st_size;
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // La projection reste valide aprs la fermeture
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw runtime_error("PathStore : projection impossible de " + file);
+    }
+#else
+    ifstream in(file.c_str(), ios::binary | ios::ate);
+    if (!in) throw runtime_error("PathStore : impossible d'ouvrir " + file);
+    mappingSize = (size_t)in.tellg();
+    mapping = ::operator new(mappingSize); // Align pour tout type fondamental
+    in.seekg(0);
+    in.read((char*)mapping, mappingSize);
+#endif
+
+    PathStoreHeader header;
+    memset(&header, 0, sizeof(header));
+    if (mappingSize >= sizeof(header)) memcpy(&header, mapping, sizeof(header));
+    long long expected = 0;
+    if (header.steps > 0 && header.nbPaths >= 0) expected = (long long)sizeof(header) + header.nbPaths * strideFor(header.steps) * (long long)sizeof(double);
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || expected != (long long)mappingSize) {
+        release(); // Le destructeur n'est pas appel si le constructeur choue
+        throw runtime_error("PathStore : fichier invalide ou tronque : " + file);
+    }
+
+    spot = header.spot;
+    rate = header.rate;
+    volatility = header.volatility;
+    maturity = header.maturity;
+    steps = header.steps;
+    nbPaths = header.nbPaths;
+    seed = header.seed;
+    stride = strideFor(steps);
+    data = (const double*)((const char*)mapping + sizeof(header));
+}
+
+PathStore::~PathStore() {
+    release();
+}
+
+void PathStore::release() {
+    if (!mapping) return;
+#ifdef PATH_STORE_MMAP
+    munmap(mapping, mappingSize);
+#else
+    ::operator delete(mapping);
+#endif
+    mapping = nullptr;
+}
+
+BlackScholesModel PathStore::getModel() const { return BlackScholesModel(spot, rate, volatility); }
+double PathStore::getMaturity() const { return maturity; }
+int PathStore::getSteps() const { return steps; }
+long long PathStore::getNbPaths() const { return nbPaths; }
+unsigned long long PathStore::getSeed() const { return seed; }
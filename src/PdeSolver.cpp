@@ -0,0 +1,181 @@
+#include "PdeSolver.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+PdeSettings::PdeSettings(int space, int time): nbSpaceSteps(space), nbTimeSteps(time), rannacherSteps(2),
+    concentration(0.5), width(6.0) {}
+
+PdeResult PdeSolver::price(const Option& option, const BlackScholesModel& model, const PdeSettings& settings) {
+    return priceLadder(option.payoffType(), vector<double>(1, option.getStrike()), option.getMaturity(), model, settings)[0];
+}
+
+// Grille x = S / K sur [0, xMax], resserre autour de x = 1 (noeud "strike" de la grille) :
+// x(u) = 1 + c * sinh(u), u uniforme de part et d'autre du strike
+static int buildGrid(vector<double>& x, int N, double xMax, double c) {
+    double low = -asinh(1.0 / c), high = asinh((xMax - 1.0) / c);
+    int strike = min(N - 2, max(2, (int)floor(N * -low / (high - low) + 0.5)));
+    for (int j = 0; j <= N; ++j) {
+        double u = j <= strike ? low * (strike - j) / strike : high * (j - strike) / (N - strike);
+        x[j] = 1.0 + c * sinh(u);
+    }
+    x[0] = 0.0;
+    x[strike] = 1.0;
+    x[N] = xMax;
+    return strike;
+}
+
+// Payoff pour K = 1, moyenn sur la cellule [x(j-1/2), x(j+1/2)] du noeud strike (l o il n'est pas rgulier)
+static double terminalValue(Option::PayoffType type, double x, double low, double high, bool strikeNode) {
+    double width = high - low;
+    switch (type) {
+    case Option::EUROPEAN_CALL: return strikeNode ? (high - 1.0) * (high - 1.0) / (2.0 * width) : max(x - 1.0, 0.0);
+    case Option::EUROPEAN_PUT:  return strikeNode ? (1.0 - low) * (1.0 - low) / (2.0 * width) : max(1.0 - x, 0.0);
+    case Option::DIGITAL_CALL:  return strikeNode ? (high - 1.0) / width : (x > 1.0 ? 1.0 : 0.0);
+    default:                    return strikeNode ? (1.0 - low) / width : (x < 1.0 ? 1.0 : 0.0);
+    }
+}
+
+// Valeurs aux bords x = 0 et x = xMax,  la dure tau avant maturit
+static void boundaryValues(Option::PayoffType type, double r, double tau, double xMax, double& low, double& high) {
+    double discount = exp(-r * tau);
+    switch (type) {
+    case Option::EUROPEAN_CALL: low = 0.0; high = xMax - discount; break;
+    case Option::EUROPEAN_PUT:  low = discount; high = 0.0; break;
+    case Option::DIGITAL_CALL:  low = 0.0; high = discount; break;
+    default:                    low = discount; high = 0.0; break;
+    }
+}
+
+// Systme (I - theta * dt * L) V = rhs factoris une fois (Thomas) : upper'[j] et 1 / pivot[j]
+struct TridiagonalSystem {
+    vector<double> lower, upper, inversePivot;
+
+    void factorize(const vector<double>& a, const vector<double>& b, const vector<double>& c, int N, double theta, double dt) {
+        lower.assign(N + 1, 0.0);
+        upper.assign(N + 1, 0.0);
+        inversePivot.assign(N + 1, 0.0);
+        for (int j = 1; j < N; ++j) {
+            lower[j] = -theta * dt * a[j];
+            double pivot = 1.0 - theta * dt * b[j] - (j > 1 ? lower[j] * upper[j - 1] : 0.0);
+            inversePivot[j] = 1.0 / pivot;
+            upper[j] = -theta * dt * c[j] * inversePivot[j];
+        }
+    }
+
+    // Rsout pour les inconnues 1..N-1, en place dans v (v[0] et v[N] sont les valeurs aux bords, dj prises en compte dans rhs)
+    void solve(const vector<double>& rhs, vector<double>& v, int N) const {
+        v[1] = rhs[1] * inversePivot[1];
+        for (int j = 2; j < N; ++j) v[j] = (rhs[j] - lower[j] * v[j - 1]) * inversePivot[j];
+        for (int j = N - 2; j >= 1; --j) v[j] -= upper[j] * v[j + 1];
+    }
+};
+
+// Un pas theta de dure dt : de v ( tau) vers v ( tau + dt), bords (low, high)  tau + dt
+static void step(const TridiagonalSystem& system, const vector<double>& a, const vector<double>& b, const vector<double>& c,
+                 double theta, double dt, double low, double high, vector<double>& v, vector<double>& rhs, int N) {
+    double explicitPart = (1.0 - theta) * dt;
+    for (int j = 1; j < N; ++j) rhs[j] = v[j] + explicitPart * (a[j] * v[j - 1] + b[j] * v[j] + c[j] * v[j + 1]);
+    rhs[1] += theta * dt * a[1] * low;
+    rhs[N - 1] += theta * dt * c[N - 1] * high;
+    v[0] = low;
+    v[N] = high;
+    system.solve(rhs, v, N);
+}
+
+// Drives premire et seconde au noeud intrieur j (diffrences centres sur grille non uniforme)
+static void nodeDerivatives(const vector<double>& x, const vector<double>& v, int j, double& first, double& second) {
+    double hm = x[j] - x[j - 1], hp = x[j + 1] - x[j];
+    first = (-hp / (hm * (hm + hp))) * v[j - 1] + ((hp - hm) / (hm * hp)) * v[j] + (hm / (hp * (hm + hp))) * v[j + 1];
+    second = 2.0 * (v[j - 1] / (hm * (hm + hp)) - v[j] / (hm * hp) + v[j + 1] / (hp * (hm + hp)));
+}
+
+vector<PdeResult> PdeSolver::priceLadder(Option::PayoffType type, const vector<double>& strikes, double T,
+                                         const BlackScholesModel& model, const PdeSettings& settings) {
+    PRICER_PROFILE_CALL("PdeSolver::priceLadder");
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (type != Option::EUROPEAN_CALL && type != Option::EUROPEAN_PUT && type != Option::DIGITAL_CALL && type != Option::DIGITAL_PUT)
+        throw invalid_argument("PdeSolver : seules les options europeennes et digitales sont prises en charge");
+    double S0 = model.getSpot(), r = model.getRate(), sigma = model.getVolatility();
+    if (!(T > 0.0) || !(sigma > 0.0)) throw invalid_argument("PdeSolver : maturite et volatilite doivent etre positives");
+    if (settings.nbSpaceSteps < 8 || settings.nbTimeSteps < 1) throw invalid_argument("PdeSolver : grille trop petite");
+    double maxMoneyness = 0.0;
+    for (size_t k = 0; k < strikes.size(); ++k) {
+        if (!(strikes[k] > 0.0)) throw invalid_argument("PdeSolver : strike invalide");
+        maxMoneyness = max(maxMoneyness, S0 / strikes[k]);
+    }
+
+    // Grille commune  tous les strikes : x = S / K, assez large pour le spot le plus dans la monnaie
+    int N = settings.nbSpaceSteps;
+    double stdDev = sigma * sqrt(T);
+    double xMax = max(exp(max(r, 0.0) * T + settings.width * stdDev), 2.0 * maxMoneyness);
+    vector<double> x(N + 1);
+    int strikeNode = buildGrid(x, N, xMax, settings.concentration * stdDev);
+
+    // Oprateur L v = 0.5 sigma^2 x^2 v'' + r x v' - r v, tridiagonal (a, b, c) sur les noeuds intrieurs
+    vector<double> a(N + 1, 0.0), b(N + 1, 0.0), c(N + 1, 0.0);
+    for (int j = 1; j < N; ++j) {
+        double hm = x[j] - x[j - 1], hp = x[j + 1] - x[j];
+        double diffusion = sigma * sigma * x[j] * x[j], drift = r * x[j];
+        a[j] = (diffusion - drift * hp) / (hm * (hm + hp));
+        c[j] = (diffusion + drift * hm) / (hp * (hm + hp));
+        b[j] = -diffusion / (hm * hp) + drift * (hp - hm) / (hm * hp) - r;
+    }
+
+    vector<double> v(N + 1), rhs(N + 1);
+    for (int j = 0; j <= N; ++j) {
+        double low = j > 0 ? 0.5 * (x[j - 1] + x[j]) : 0.0, high = j < N ? 0.5 * (x[j] + x[j + 1]) : xMax;
+        v[j] = terminalValue(type, x[j], low, high, j == strikeNode);
+    }
+
+    // Rannacher : demi-pas implicites (theta = 1) au dpart, puis Crank-Nicolson (theta = 1/2)
+    double dt = T / settings.nbTimeSteps;
+    int smoothing = min(settings.rannacherSteps, settings.nbTimeSteps);
+    TridiagonalSystem implicit, crankNicolson;
+    if (smoothing > 0) implicit.factorize(a, b, c, N, 1.0, 0.5 * dt);
+    crankNicolson.factorize(a, b, c, N, 0.5, dt);
+    double tau = 0.0, low, high;
+    for (int n = 0; n < settings.nbTimeSteps; ++n) {
+        if (n < smoothing) {
+            for (int half = 0; half < 2; ++half) {
+                tau += 0.5 * dt;
+                boundaryValues(type, r, tau, xMax, low, high);
+                step(implicit, a, b, c, 1.0, 0.5 * dt, low, high, v, rhs, N);
+            }
+        } else {
+            tau = (n + 1) * dt;
+            boundaryValues(type, r, tau, xMax, low, high);
+            step(crankNicolson, a, b, c, 0.5, dt, low, high, v, rhs, N);
+        }
+    }
+
+    // Lecture de chaque strike : v, v' et v'' aux deux noeuds qui encadrent S0 / K, interpolation d'Hermite cubique
+    // pour le prix (et sa drive pour Delta), linaire pour v'' (Gamma continu en S)
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    vector<PdeResult> results(strikes.size());
+    for (size_t k = 0; k < strikes.size(); ++k) {
+        double K = strikes[k];
+        double scale = (type == Option::EUROPEAN_CALL || type == Option::EUROPEAN_PUT) ? K : 1.0; // V = scale * v(S / K)
+        double x0 = S0 / K;
+        int j = (int)(upper_bound(x.begin(), x.end(), x0) - x.begin()) - 1;
+        j = min(max(j, 1), N - 2);
+        double d1, d2, g1, g2;
+        nodeDerivatives(x, v, j, d1, g1);
+        nodeDerivatives(x, v, j + 1, d2, g2);
+        double h = x[j + 1] - x[j], t = (x0 - x[j]) / h;
+        double t2 = t * t, t3 = t2 * t;
+        double value = (2 * t3 - 3 * t2 + 1) * v[j] + (t3 - 2 * t2 + t) * h * d1 + (-2 * t3 + 3 * t2) * v[j + 1] + (t3 - t2) * h * d2;
+        double slope = ((6 * t2 - 6 * t) * (v[j] - v[j + 1])) / h + (3 * t2 - 4 * t + 1) * d1 + (3 * t2 - 2 * t) * d2;
+        double curvature = (1.0 - t) * g1 + t * g2;
+
+        results[k].price = scale * value;
+        results[k].delta = scale * slope / K;
+        results[k].gamma = scale * curvature / (K * K);
+        results[k].elapsedSeconds = elapsed;
+    }
+    return results;
+}
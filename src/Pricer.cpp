@@ -0,0 +1,203 @@
+#include "Pricer.h"
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <tuple>
+
+using namespace std;
+
+static const struct {
+    const char* name;
+    Option::PayoffType type;
+} OPTION_TYPES[] = {
+    { "CallEuropeen", Option::EUROPEAN_CALL },
+    { "PutEuropeen", Option::EUROPEAN_PUT },
+    { "CallAsiatique", Option::ASIAN_CALL },
+    { "PutAsiatique", Option::ASIAN_PUT },
+    { "CallAsiatiqueGeometrique", Option::GEOMETRIC_ASIAN_CALL },
+    { "PutAsiatiqueGeometrique", Option::GEOMETRIC_ASIAN_PUT },
+    { "CallDigital", Option::DIGITAL_CALL },
+    { "PutDigital", Option::DIGITAL_PUT },
+    { "CallLookback", Option::LOOKBACK_CALL },
+    { "PutLookback", Option::LOOKBACK_PUT },
+};
+static const int NB_OPTION_TYPES = sizeof(OPTION_TYPES) / sizeof(OPTION_TYPES[0]);
+
+bool Pricer::parseType(const char* name, size_t length, Option::PayoffType& type) {
+    for (int t = 0; t < NB_OPTION_TYPES; ++t) {
+        if (strlen(OPTION_TYPES[t].name) == length && memcmp(OPTION_TYPES[t].name, name, length) == 0) {
+            type = OPTION_TYPES[t].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Pricer::typeName(Option::PayoffType type) {
+    for (int t = 0; t < NB_OPTION_TYPES; ++t)
+        if (OPTION_TYPES[t].type == type) return OPTION_TYPES[t].name;
+    return "";
+}
+
+Option* Pricer::createOption(const string& name, double T, double K, TradeArena& arena) {
+    Option::PayoffType type;
+    return parseType(name.c_str(), name.size(), type) ? arena.createOption(type, T, K) : nullptr;
+}
+
+// Champ [begin, end) d'une ligne, sans les blancs autour (aucune copie)
+struct Field {
+    const char* begin;
+    const char* end;
+
+    size_t size() const { return end - begin; }
+    string str() const { return string(begin, end); } // Messages d'erreur seulement
+};
+
+static Field trim(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+    Field field = { begin, end };
+    return field;
+}
+
+// Nombre occupant tout le champ (copi dans un tampon local pour strtod, qui attend une chane termine)
+static bool parseNumber(const Field& field, double& value) {
+    char buffer[64];
+    if (field.size() == 0 || field.size() >= sizeof(buffer)) return false;
+    memcpy(buffer, field.begin, field.size());
+    buffer[field.size()] = '\0';
+    char* end = nullptr;
+    value = strtod(buffer, &end);
+    return *end == '\0';
+}
+
+// Nombre strictement positif occupant tout le champ
+static bool parsePositive(const Field& field, double& value) {
+    return parseNumber(field, value) && value > 0.0;
+}
+
+bool Pricer::parseTrade(const string& line, TradeArena& arena, Trade& trade, string& error) {
+    Field fields[7];
+    int nbFields = 0;
+    const char* begin = line.c_str();
+    const char* stop = begin + line.size();
+    for (const char* p = begin;; ++p) {
+        if (p == stop || *p == ',') {
+            if (nbFields < 7) fields[nbFields] = trim(begin, p);
+            ++nbFields;
+            begin = p + 1;
+            if (p == stop) break;
+        }
+    }
+    if (nbFields != 7) {
+        error = "7 champs attendus (id,type,strike,maturity,spot,rate,volatility)";
+        return false;
+    }
+
+    double K, T, S0, r, vol;
+    if (!parsePositive(fields[2], K)) { error = "strike invalide : " + fields[2].str(); return false; }
+    if (!parsePositive(fields[3], T)) { error = "maturite invalide : " + fields[3].str(); return false; }
+    if (!parsePositive(fields[4], S0)) { error = "spot invalide : " + fields[4].str(); return false; }
+    if (!parseNumber(fields[5], r)) { error = "taux invalide : " + fields[5].str(); return false; } // Un taux peut tre ngatif
+    if (!parsePositive(fields[6], vol)) { error = "volatilite invalide : " + fields[6].str(); return false; }
+
+    Option::PayoffType type;
+    if (!parseType(fields[1].begin, fields[1].size(), type)) { error = "type d'option inconnu : " + fields[1].str(); return false; }
+
+    trade.id = arena.copyString(fields[0].begin, fields[0].size());
+    trade.type = type;
+    trade.option = arena.createOption(type, T, K);
+    trade.spot = S0;
+    trade.rate = r;
+    trade.volatility = vol;
+    return true;
+}
+
+void Pricer::priceAll(const vector<Trade>& trades, int nbSimulations, const MonteCarloSettings& settings,
+                      const function<void(size_t, const TradeResult&)>& onResult) {
+    // Regroupement par scnario de march et maturit, dans l'ordre de premire apparition
+    typedef tuple<double, double, double, double> GroupKey; // (S0, r, sigma, T)
+    map<GroupKey, size_t> groupIndex;
+    vector<vector<size_t> > groups;
+
+    for (size_t i = 0; i < trades.size(); ++i) {
+        const Trade& trade = trades[i];
+        const Option& option = *trade.option;
+        Option::ClosedForm closedForm = option.closedForm();
+        if (closedForm != Option::NO_CLOSED_FORM) { // Formule ferme : tout de suite, aux dates qu'aurait Monte Carlo
+            BlackScholesModel model(trade.spot, trade.rate, trade.volatility);
+            double price = option.closedFormPrice(model, MonteCarlo::stepsFor(option.getMaturity()));
+            TradeResult result = { closedForm == Option::EXACT ? "formule" : "formule-corrigee", price, 0.0, 0 };
+            onResult(i, result);
+            continue;
+        }
+        GroupKey key(trade.spot, trade.rate, trade.volatility, option.getMaturity());
+        map<GroupKey, size_t>::iterator found = groupIndex.find(key);
+        if (found == groupIndex.end()) {
+            found = groupIndex.insert(make_pair(key, groups.size())).first;
+            groups.push_back(vector<size_t>());
+        }
+        groups[found->second].push_back(i);
+    }
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const Trade& first = trades[groups[g][0]];
+        BlackScholesModel model(first.spot, first.rate, first.volatility);
+        vector<const Option*> options;
+        for (size_t j = 0; j < groups[g].size(); ++j) options.push_back(trades[groups[g][j]].option);
+
+        vector<MonteCarloResult> results = MonteCarlo::estimateMany(options, model, nbSimulations, settings);
+        for (size_t j = 0; j < results.size(); ++j) {
+            TradeResult result = { "monte-carlo", results[j].price, results[j].stdError, results[j].nbPaths };
+            onResult(groups[g][j], result);
+        }
+    }
+}
+
+vector<TradeResult> Pricer::priceAll(const vector<Trade>& trades, int nbSimulations, const MonteCarloSettings& settings) {
+    vector<TradeResult> results(trades.size());
+    priceAll(trades, nbSimulations, settings, [&](size_t i, const TradeResult& result) { results[i] = result; });
+    return results;
+}
+
+void Pricer::writeResult(ostream& out, const Trade& trade, const TradeResult& result) {
+    out << trade.id << ',' << typeName(trade.type) << ',' << trade.option->getStrike() << ',' << trade.option->getMaturity() << ','
+        << trade.spot << ',' << trade.rate << ',' << trade.volatility << ',' << result.method << ','
+        << result.price << ',' << result.stdError << ',' << result.nbPaths;
+}
+
+int Pricer::runBatch(istream& in, ostream& out, ostream& errors, int nbSimulations, const MonteCarloSettings& settings) {
+    TradeBook book;
+    return runBatch(in, out, errors, nbSimulations, settings, book);
+}
+
+int Pricer::runBatch(istream& in, ostream& out, ostream& errors, int nbSimulations, const MonteCarloSettings& settings, TradeBook& book) {
+    book.clear();
+    vector<Trade>& trades = book.trades;
+    int rejected = 0, lineNumber = 0;
+    string& line = book.line;
+    string& error = book.error;
+    while (getline(in, line)) { // "line" garde sa capacit d'une ligne et d'un lot  l'autre
+        ++lineNumber;
+        Field content = trim(line.c_str(), line.c_str() + line.size());
+        if (content.size() == 0 || *content.begin == '#' || (content.size() >= 3 && memcmp(content.begin, "id,", 3) == 0)) continue; // Vide, commentaire ou en-tte
+        Trade trade;
+        if (parseTrade(line, book.arena, trade, error)) {
+            trades.push_back(trade);
+        } else {
+            errors << "ligne " << lineNumber << " : " << error << endl;
+            ++rejected;
+        }
+    }
+
+    out << "id,type,strike,maturity,spot,rate,volatility,method,price,std_error,paths" << '\n';
+    out << setprecision(12);
+    priceAll(trades, nbSimulations, settings, [&](size_t i, const TradeResult& result) {
+        writeResult(out, trades[i], result);
+        out << '\n';
+    });
+    out.flush();
+    return rejected;
+}
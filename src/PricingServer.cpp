@@ -0,0 +1,433 @@
+#include "PricingServer.h"
+#include "Pricer.h"
+#include "TradeArena.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PRICING_SERVER_SOCKETS
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+using namespace std;
+
+PricingServerSettings::PricingServerSettings(const string& path): socketPath(path), nbWorkers(0), nbSimulations(100000),
+    monteCarlo(1, 1), coalesceMicros(1000), maxGroupSize(256) {}
+
+string PricingServerStats::summary() const {
+    ostringstream out;
+    out << "requetes=" << requests << " formule=" << closedForm << " monte_carlo=" << monteCarlo << " groupes=" << groups
+        << " taille_moyenne_groupe=" << meanGroupSize << " rejets=" << rejected << " echecs=" << failed << " p50_ms=" << p50Ms << " p99_ms=" << p99Ms
+        << " requetes_par_s=" << requestsPerSecond;
+    return out.str();
+}
+
+static const int SEND_TIMEOUT_MS = 1000;
+
+typedef chrono::steady_clock Clock;
+typedef tuple<double, double, double, double> GroupKey; // (S0, r, sigma, T), comme les groupes du mode batch
+
+// Connexion d'un client. Les rponses viennent du thread de lecture (formules) et des workers : une ligne est
+// crite d'un seul tenant. Un client qui ne lit plus (tampon de la socket plein pendant SEND_TIMEOUT_MS) est abandonn :
+// un worker du pool n'attend jamais un client plus longtemps. La socket est ferme avec le dernier dtenteur (une
+// requte en cours garde la connexion).
+struct Connection {
+    int fd;
+    mutex writeAccess;
+    bool dropped; // Client parti ou abandonn : plus rien ne lui est envoy
+
+    explicit Connection(int socket): fd(socket), dropped(false) {}
+    ~Connection();
+    void send(const string& line);
+};
+
+// Requte Monte Carlo en attente ; le march et la maturit sont ceux de son groupe
+struct Request {
+    shared_ptr<Connection> client;
+    string id;
+    Option::PayoffType type;
+    double strike;
+    Clock::time_point received;
+};
+
+struct Group {
+    GroupKey key;
+    Clock::time_point created;
+    vector<Request> requests;
+};
+
+struct PricingServer::State {
+    PricingServerSettings settings;
+    Clock::time_point start;
+
+    mutex queueAccess;
+    condition_variable queueReady;
+    deque<shared_ptr<Group> > queue;          // Groupes pas encore pris par un worker, du plus ancien au plus rcent
+    map<GroupKey, shared_ptr<Group> > open;   // Groupe que rejoint une nouvelle requte de mme cl
+    bool stopping;
+
+    mutex connectionsAccess;
+    condition_variable readersDone;
+    vector<shared_ptr<Connection> > connections; // Connexions dont le thread de lecture tourne encore
+
+    mutable mutex statsAccess;
+    vector<double> latencies; // Anneau des LATENCY_WINDOW dernires latences (ms)
+    long long nbLatencies, closedForm, monteCarlo, groups, groupedRequests, rejected, failed;
+
+    explicit State(const PricingServerSettings& s): settings(s), start(Clock::now()), stopping(false), latencies(LATENCY_WINDOW),
+        nbLatencies(0), closedForm(0), monteCarlo(0), groups(0), groupedRequests(0), rejected(0), failed(0) {}
+
+    void readConnection(shared_ptr<Connection> client);
+    void handleLine(const shared_ptr<Connection>& client, const string& line, TradeArena& arena, string& error);
+    void enqueue(Request& request, const GroupKey& key);
+    void work();
+    void runGroup(Group& group, TradeArena& arena, vector<const Option*>& options, vector<Trade>& trades);
+    void respond(Connection& client, const Trade& trade, const TradeResult& result, const double* greeks, Clock::time_point received,
+                 bool isClosedForm);
+    void record(Clock::time_point received, bool isClosedForm);
+    PricingServerStats stats() const;
+};
+
+#ifdef PRICING_SERVER_SOCKETS
+
+Connection::~Connection() {
+    close(fd);
+}
+
+void Connection::send(const string& line) {
+    lock_guard<mutex> lock(writeAccess);
+    if (dropped) return;
+    const char* data = line.data();
+    size_t size = line.size();
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL); // Born par SO_SNDTIMEO
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) { // Client parti (sans SIGPIPE) ou muet au-del du dlai : abandonn, son thread de lecture sort de recv
+            dropped = true;
+            shutdown(fd, SHUT_RDWR);
+            return;
+        }
+        data += sent;
+        size -= (size_t)sent;
+    }
+}
+
+void PricingServer::State::readConnection(shared_ptr<Connection> client) {
+    TradeArena arena; // Contrat de la ligne en cours
+    string pending, line, error;
+    char buffer[4096];
+    for (;;) {
+        ssize_t received = recv(client->fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        pending.append(buffer, (size_t)received);
+        size_t begin = 0, end;
+        while ((end = pending.find('\n', begin)) != string::npos) {
+            line.assign(pending, begin, end - begin);
+            begin = end + 1;
+            handleLine(client, line, arena, error);
+        }
+        pending.erase(0, begin);
+        if (pending.size() > 65536) break; // Pas une ligne de contrat
+    }
+    lock_guard<mutex> lock(connectionsAccess);
+    connections.erase(find(connections.begin(), connections.end(), client));
+    readersDone.notify_all();
+}
+
+#else
+
+Connection::~Connection() {}
+void Connection::send(const string&) {}
+void PricingServer::State::readConnection(shared_ptr<Connection>) {}
+
+#endif
+
+void PricingServer::State::handleLine(const shared_ptr<Connection>& client, const string& line, TradeArena& arena, string& error) {
+    Clock::time_point received = Clock::now();
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == string::npos || line[first] == '#') return; // Vide ou commentaire
+    size_t length = line.find_last_not_of(" \t\r") + 1 - first;
+    // Lignes reconnues en entier : un contrat dont l'id commence par "stats" ou vaut "id" est valoris comme les autres
+    if (line.compare(first, length, "id,type,strike,maturity,spot,rate,volatility") == 0) return; // En-tte du mode batch
+    if (line.compare(first, length, "stats") == 0) {
+        client->send("#stats " + stats().summary() + "\n");
+        return;
+    }
+
+    arena.reset();
+    Trade trade;
+    if (!Pricer::parseTrade(line, arena, trade, error)) {
+        {
+            lock_guard<mutex> lock(statsAccess);
+            ++rejected;
+        }
+        // Premier champ de la ligne (l'id, s'il a pu tre lu) : le client retrouve la requte refuse parmi celles en cours
+        size_t comma = line.find(',', first);
+        string id = line.substr(first, (comma == string::npos ? first + length : comma) - first);
+        id.erase(id.find_last_not_of(" \t\r") + 1);
+        client->send("#erreur : " + id + " : " + error + "\n");
+        return;
+    }
+
+    const Option& option = *trade.option;
+    Option::ClosedForm closedForm = option.closedForm();
+    if (closedForm == Option::NO_CLOSED_FORM) {
+        Request request = { client, trade.id, trade.type, option.getStrike(), received };
+        enqueue(request, GroupKey(trade.spot, trade.rate, trade.volatility, option.getMaturity()));
+        return;
+    }
+
+    // Voie rapide : formule ferme dans le thread de lecture, avec les Grecs Black-Scholes des Europennes
+    double K = option.getStrike(), T = option.getMaturity();
+    BlackScholesModel model(trade.spot, trade.rate, trade.volatility);
+    TradeResult result = { closedForm == Option::EXACT ? "formule" : "formule-corrigee",
+                           option.closedFormPrice(model, MonteCarlo::stepsFor(T)), 0.0, 0 };
+    bool isCall = trade.type == Option::EUROPEAN_CALL;
+    if (isCall || trade.type == Option::EUROPEAN_PUT) {
+        double greeks[3] = { model.bsDelta(K, T, isCall), model.bsGamma(K, T), model.bsVega(K, T) };
+        respond(*client, trade, result, greeks, received, true);
+    } else {
+        respond(*client, trade, result, nullptr, received, true);
+    }
+}
+
+void PricingServer::State::enqueue(Request& request, const GroupKey& key) {
+    lock_guard<mutex> lock(queueAccess);
+    if (stopping) return;
+    map<GroupKey, shared_ptr<Group> >::iterator found = open.find(key);
+    if (found == open.end() || (int)found->second->requests.size() >= settings.maxGroupSize) {
+        shared_ptr<Group> group(new Group());
+        group->key = key;
+        group->created = request.received;
+        queue.push_back(group);
+        open[key] = group; // Un groupe plein reste en file, mais n'accepte plus personne
+        group->requests.push_back(request);
+        queueReady.notify_one();
+    } else {
+        found->second->requests.push_back(request);
+    }
+}
+
+void PricingServer::State::work() {
+    TradeArena arena; // Options du groupe en cours, dans les mmes pages d'un groupe  l'autre
+    vector<const Option*> options;
+    vector<Trade> trades;
+    for (;;) {
+        shared_ptr<Group> group;
+        {
+            unique_lock<mutex> lock(queueAccess);
+            queueReady.wait(lock, [&]() { return stopping || !queue.empty(); });
+            if (stopping) return;
+            group = queue.front();
+            queue.pop_front();
+            // Fentre de regroupement : le groupe reste ouvert aux requtes concurrentes de mme cl
+            Clock::time_point deadline = group->created + chrono::microseconds(settings.coalesceMicros);
+            if (Clock::now() < deadline) {
+                lock.unlock();
+                this_thread::sleep_until(deadline);
+                lock.lock();
+            }
+            map<GroupKey, shared_ptr<Group> >::iterator found = open.find(group->key);
+            if (found != open.end() && found->second == group) open.erase(found);
+        }
+        runGroup(*group, arena, options, trades);
+    }
+}
+
+void PricingServer::State::runGroup(Group& group, TradeArena& arena, vector<const Option*>& options, vector<Trade>& trades) {
+    double S0 = get<0>(group.key), r = get<1>(group.key), sigma = get<2>(group.key), T = get<3>(group.key);
+    arena.reset();
+    options.clear();
+    trades.clear();
+    for (size_t k = 0; k < group.requests.size(); ++k) {
+        const Request& request = group.requests[k];
+        Trade trade = { request.id.c_str(), request.type, arena.createOption(request.type, T, request.strike), S0, r, sigma };
+        options.push_back(trade.option);
+        trades.push_back(trade);
+    }
+    try {
+        vector<MonteCarloResult> results = MonteCarlo::estimateMany(options, BlackScholesModel(S0, r, sigma), settings.nbSimulations,
+                                                                    settings.monteCarlo);
+        {
+            lock_guard<mutex> lock(statsAccess);
+            ++groups;
+            groupedRequests += results.size();
+        }
+        for (size_t k = 0; k < results.size(); ++k) {
+            TradeResult result = { "monte-carlo", results[k].price, results[k].stdError, results[k].nbPaths };
+            respond(*group.requests[k].client, trades[k], result, nullptr, group.requests[k].received, false);
+        }
+    } catch (const exception& e) {
+        {
+            lock_guard<mutex> lock(statsAccess);
+            failed += group.requests.size(); // Avant les rponses : une requte "stats" qui suit les compte
+        }
+        for (size_t k = 0; k < group.requests.size(); ++k)
+            group.requests[k].client->send("#erreur : " + group.requests[k].id + " : " + e.what() + "\n");
+    }
+}
+
+void PricingServer::State::respond(Connection& client, const Trade& trade, const TradeResult& result, const double* greeks,
+                                   Clock::time_point received, bool isClosedForm) {
+    ostringstream out;
+    out << setprecision(12);
+    Pricer::writeResult(out, trade, result);
+    if (greeks) out << ',' << greeks[0] << ',' << greeks[1] << ',' << greeks[2] << '\n';
+    else out << ",,,\n";
+    record(received, isClosedForm); // Avant l'envoi : une requte "stats" qui suit la rponse la compte
+    client.send(out.str());
+}
+
+void PricingServer::State::record(Clock::time_point received, bool isClosedForm) {
+    double milliseconds = chrono::duration<double, milli>(Clock::now() - received).count();
+    lock_guard<mutex> lock(statsAccess);
+    latencies[nbLatencies++ % LATENCY_WINDOW] = milliseconds;
+    ++(isClosedForm ? closedForm : monteCarlo);
+}
+
+PricingServer::PricingServer(const PricingServerSettings& settings): state(new State(settings)) {}
+
+PricingServer::~PricingServer() {
+    delete state;
+}
+
+PricingServerStats PricingServer::State::stats() const {
+    PricingServerStats result;
+    vector<double> window;
+    {
+        lock_guard<mutex> lock(statsAccess);
+        result.closedForm = closedForm;
+        result.monteCarlo = monteCarlo;
+        result.requests = closedForm + monteCarlo;
+        result.groups = groups;
+        result.rejected = rejected;
+        result.failed = failed;
+        result.meanGroupSize = groups > 0 ? (double)groupedRequests / groups : 0.0;
+        window.assign(latencies.begin(), latencies.begin() + min(nbLatencies, (long long)LATENCY_WINDOW));
+    }
+    double percentiles[2] = { 0.5, 0.99 }, values[2] = { 0.0, 0.0 };
+    for (int p = 0; p < 2 && !window.empty(); ++p) {
+        vector<double>::iterator nth = window.begin() + (size_t)(percentiles[p] * (window.size() - 1) + 0.5);
+        nth_element(window.begin(), nth, window.end());
+        values[p] = *nth;
+    }
+    result.p50Ms = values[0];
+    result.p99Ms = values[1];
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+    result.requestsPerSecond = elapsed > 0.0 ? result.requests / elapsed : 0.0;
+    return result;
+}
+
+PricingServerStats PricingServer::stats() const {
+    return state->stats();
+}
+
+#ifdef PRICING_SERVER_SOCKETS
+
+// Adresse de la socket locale ; false si le chemin est vide ou trop long
+static bool socketAddress(const string& path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+void PricingServer::run() {
+    const string& path = state->settings.socketPath;
+    sockaddr_un address;
+    if (!socketAddress(path, address)) throw runtime_error("PricingServer : chemin de socket invalide : " + path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) throw runtime_error("PricingServer : creation de socket impossible");
+    unlink(path.c_str()); // Socket laisse par un service prcdent
+    if (::bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        close(listener);
+        throw runtime_error("PricingServer : impossible d'ecouter sur " + path);
+    }
+
+    int nbWorkers = state->settings.nbWorkers > 0 ? state->settings.nbWorkers : ThreadPool::hardwareThreads();
+    vector<thread> workers;
+    for (int w = 0; w < nbWorkers; ++w) workers.push_back(thread(&State::work, state));
+
+    // stop() se connecte  la socket pour rveiller accept() : l'arrt est vu avant ou juste aprs
+    auto stopping = [&]() {
+        lock_guard<mutex> lock(state->queueAccess);
+        return state->stopping;
+    };
+    while (!stopping()) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        if (stopping()) {
+            close(fd);
+            break;
+        }
+        timeval delay = { SEND_TIMEOUT_MS / 1000, (SEND_TIMEOUT_MS % 1000) * 1000 };
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &delay, sizeof(delay));
+        shared_ptr<Connection> client(new Connection(fd));
+        lock_guard<mutex> lock(state->connectionsAccess);
+        state->connections.push_back(client);
+        thread(&State::readConnection, state, client).detach();
+    }
+
+    // Arrt : les lectures en cours sont interrompues, les workers finissent leur groupe ; les requtes en file sont abandonnes
+    {
+        unique_lock<mutex> lock(state->connectionsAccess);
+        for (size_t c = 0; c < state->connections.size(); ++c) shutdown(state->connections[c]->fd, SHUT_RDWR);
+        state->readersDone.wait(lock, [&]() { return state->connections.empty(); });
+    }
+    state->queueReady.notify_all();
+    for (size_t w = 0; w < workers.size(); ++w) workers[w].join();
+    {
+        lock_guard<mutex> lock(state->queueAccess);
+        state->queue.clear();
+        state->open.clear();
+    }
+    close(listener);
+    unlink(path.c_str());
+}
+
+void PricingServer::stop() {
+    {
+        lock_guard<mutex> lock(state->queueAccess);
+        if (state->stopping) return;
+        state->stopping = true;
+    }
+    state->queueReady.notify_all();
+    // Rveille accept() (run) par une connexion  la socket elle-mme
+    sockaddr_un address;
+    if (!socketAddress(state->settings.socketPath, address)) return;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    connect(fd, (sockaddr*)&address, sizeof(address));
+    close(fd);
+}
+
+#else
+
+void PricingServer::run() {
+    throw runtime_error("PricingServer : sockets POSIX indisponibles sur ce systeme");
+}
+
+void PricingServer::stop() {}
+
+#endif
@@ -0,0 +1,76 @@
+#include "RandomStream.h"
+#include "SimdMath.h"
+
+// Constantes de Philox4x32 (multiplicateurs et incrments de Weyl pour la cl)
+static const uint32_t PHILOX_M0 = 0xD2511F53u;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream): index(4) {
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t)stream;
+    counter[3] = (uint32_t)(stream >> 32);
+    buffer[0] = buffer[1] = buffer[2] = buffer[3] = 0;
+}
+
+// 10 tours de Philox sur un compteur de 128 bits : multiplication 32x32 -> 64 bits, puis mlange avec la cl
+static inline void philox(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3, uint32_t k0, uint32_t k1, uint32_t* out) {
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * x0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * x2;
+        uint32_t y0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+        uint32_t y1 = (uint32_t)p1;
+        uint32_t y2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+        uint32_t y3 = (uint32_t)p0;
+        x0 = y0; x1 = y1; x2 = y2; x3 = y3;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = x0; out[1] = x1; out[2] = x2; out[3] = x3;
+}
+
+void RandomStream::refill() {
+    philox(counter[0], counter[1], counter[2], counter[3], key[0], key[1], buffer);
+    index = 0;
+
+    // Incrment du compteur de position (64 bits rpartis sur counter[0] et counter[1])
+    if (++counter[0] == 0) ++counter[1];
+}
+
+SIMD_CLONES
+void RandomStream::fill(uint32_t* out, int n) {
+    int i = 0;
+    while (i < n && index < 4) out[i++] = buffer[index++]; // Reste du bloc courant
+
+    // Blocs complets : les compteurs sont indpendants, donc les valuations aussi (vectorisable)
+    int nbBlocks = (n - i) / 4;
+    uint64_t position = ((uint64_t)counter[1] << 32) | counter[0];
+    for (int b = 0; b < nbBlocks; ++b) {
+        uint64_t c = position + b;
+        philox((uint32_t)c, (uint32_t)(c >> 32), counter[2], counter[3], key[0], key[1], out + i + 4 * b);
+    }
+    position += nbBlocks;
+    counter[0] = (uint32_t)position;
+    counter[1] = (uint32_t)(position >> 32);
+    i += 4 * nbBlocks;
+
+    while (i < n) out[i++] = (*this)(); // Fin du tableau
+}
+
+void RandomStream::discard(unsigned long long n) {
+    // On consomme d'abord ce qui reste dans le buffer courant
+    while (n > 0 && index < 4) { ++index; --n; }
+    if (n == 0) return;
+
+    // Saut direct du compteur : chaque valuation produit 4 valeurs
+    uint64_t position = ((uint64_t)counter[1] << 32) | counter[0];
+    position += n / 4;
+    counter[0] = (uint32_t)position;
+    counter[1] = (uint32_t)(position >> 32);
+    refill();
+    index = (int)(n % 4);
+}
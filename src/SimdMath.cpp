@@ -0,0 +1,211 @@
+#include "SimdMath.h"
+#include <cstring>
+#include <cmath>
+
+static const double LN2_HI = 6.93147180369123816490e-01; // ln(2) dcoup en deux pour une rduction exacte
+static const double LN2_LO = 1.90821492927058770002e-10;
+static const double LOG2E = 1.44269504088896338700e+00;
+static const double SHIFTER = 6755399441055744.0; // 1.5 * 2^52 : arrondi  l'entier le plus proche par addition
+static const uint64_t SQRT1_2_BITS = 0x3FE6A09E667F3BCDull; // Bits de sqrt(2)/2
+static const double TWO_PI = 6.28318530717958647693;
+static const double INV_2_32 = 1.0 / 4294967296.0;
+
+static inline uint64_t toBits(double x) { uint64_t b; memcpy(&b, &x, sizeof(b)); return b; }
+static inline double fromBits(uint64_t b) { double x; memcpy(&x, &b, sizeof(x)); return x; }
+static inline double select(bool condition, double a, double b) { // condition ? a : b, par masque de bits
+    uint64_t mask = 0 - (uint64_t)condition;
+    return fromBits((toBits(a) & mask) | (toBits(b) & ~mask));
+}
+
+// exp(x) = 2^k * exp(r), avec |r| <= ln(2)/2 et exp(r) approch par son dveloppement de Taylor (degr 12)
+// Pas de test de dpassement : x doit rester dans [-708, 709] (rsultat normalis)
+static inline double expKernel(double x) {
+    double t = x * LOG2E + SHIFTER;
+    double k = t - SHIFTER;
+    double r = (x - k * LN2_HI) - k * LN2_LO;
+
+    double p = 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // Multiplication par 2^k : on ajoute k directement  l'exposant
+    int64_t ki = (int64_t)(toBits(t) - toBits(SHIFTER));
+    return fromBits(toBits(p) + ((uint64_t)ki << 52));
+}
+
+// log(x) = e*ln(2) + log(m), avec m dans [sqrt(2)/2, sqrt(2)] et log(m) = 2*atanh(f), f = (m-1)/(m+1)
+static inline double logKernel(double x) {
+    // Dcalage des bits par ceux de sqrt(2)/2 : l'exposant obtenu place directement m dans le bon intervalle
+    uint64_t bits = toBits(x);
+    int64_t e = (int64_t)(bits - SQRT1_2_BITS) >> 52;
+    double m = fromBits(bits - ((uint64_t)e << 52));
+    double ed = fromBits(toBits(SHIFTER) + (uint64_t)e) - SHIFTER; // Conversion entier -> double par le mme arrondi
+
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+    double p = 1.0 / 21.0;
+    p = p * s + 1.0 / 19.0;
+    p = p * s + 1.0 / 17.0;
+    p = p * s + 1.0 / 15.0;
+    p = p * s + 1.0 / 13.0;
+    p = p * s + 1.0 / 11.0;
+    p = p * s + 1.0 / 9.0;
+    p = p * s + 1.0 / 7.0;
+    p = p * s + 1.0 / 5.0;
+    p = p * s + 1.0 / 3.0;
+    p = p * s + 1.0;
+    return ed * LN2_HI + (2.0 * f * p + ed * LN2_LO);
+}
+
+// sin et cos de 2*pi*u pour u dans [0, 1) : rduction au quadrant puis Taylor sur [-pi/4, pi/4]
+static inline void sinCos2Pi(double u, double& s, double& c) {
+    double t = 4.0 * u + SHIFTER;
+    double q = t - SHIFTER; // Quadrant le plus proche (0  4)
+    double x = (u - 0.25 * q) * TWO_PI;
+    double x2 = x * x;
+
+    double ps = -1.0 / 1307674368000.0;
+    ps = ps * x2 + 1.0 / 6227020800.0;
+    ps = ps * x2 - 1.0 / 39916800.0;
+    ps = ps * x2 + 1.0 / 362880.0;
+    ps = ps * x2 - 1.0 / 5040.0;
+    ps = ps * x2 + 1.0 / 120.0;
+    ps = ps * x2 - 1.0 / 6.0;
+    ps = ps * x2 + 1.0;
+    double sx = ps * x;
+
+    double pc = 1.0 / 20922789888000.0;
+    pc = pc * x2 - 1.0 / 87178291200.0;
+    pc = pc * x2 + 1.0 / 479001600.0;
+    pc = pc * x2 - 1.0 / 3628800.0;
+    pc = pc * x2 + 1.0 / 40320.0;
+    pc = pc * x2 - 1.0 / 720.0;
+    pc = pc * x2 + 1.0 / 24.0;
+    pc = pc * x2 - 0.5;
+    pc = pc * x2 + 1.0;
+    double cx = pc;
+
+    // Rotation selon le quadrant, par masques de bits (sans branchement)
+    uint64_t quadrant = toBits(t) & 3;
+    uint64_t swap = 0 - (quadrant & 1);
+    double s1 = fromBits((toBits(cx) & swap) | (toBits(sx) & ~swap));
+    double c1 = fromBits((toBits(sx) & swap) | (toBits(cx) & ~swap));
+    s = fromBits(toBits(s1) ^ ((quadrant & 2) << 62));
+    c = fromBits(toBits(c1) ^ (((quadrant + 1) & 2) << 62));
+}
+
+// N(x) par l'approximation de Hart (1968), sous la forme de West (2005) : fraction rationnelle pour |x| < 7.07,
+// fraction continue au-del. Les deux branches sont calcules puis slectionnes (pas de saut conditionnel).
+static inline double normalCdfKernel(double x) {
+    double xa = fromBits(toBits(x) & 0x7FFFFFFFFFFFFFFFull); // |x|
+    xa = select(xa > 37.0, 37.0, xa); // Au-del, N(x) vaut 0 ou 1 en double prcision
+    double e = expKernel(-0.5 * xa * xa);
+
+    double num = 3.52624965998911e-02;
+    num = num * xa + 0.700383064443688;
+    num = num * xa + 6.37396220353165;
+    num = num * xa + 33.912866078383;
+    num = num * xa + 112.079291497871;
+    num = num * xa + 221.213596169931;
+    num = num * xa + 220.206867912376;
+    double den = 8.83883476483184e-02;
+    den = den * xa + 1.75566716318264;
+    den = den * xa + 16.064177579207;
+    den = den * xa + 86.7807322029461;
+    den = den * xa + 296.564248779674;
+    den = den * xa + 637.333633378831;
+    den = den * xa + 793.826512519948;
+    den = den * xa + 440.413735824752;
+    double rational = e * num / den;
+
+    double cf = xa + 0.65;
+    cf = xa + 4.0 / cf;
+    cf = xa + 3.0 / cf;
+    cf = xa + 2.0 / cf;
+    cf = xa + 1.0 / cf;
+    double tail = e / cf / 2.506628274631;
+
+    double lower = select(xa < 7.07106781186547, rational, tail); // N(-|x|)
+    return select(x > 0.0, 1.0 - lower, lower);
+}
+
+SIMD_CLONES
+void SimdMath::exp(const double* x, double* y, int n) {
+    for (int i = 0; i < n; ++i) y[i] = expKernel(x[i]);
+}
+
+SIMD_CLONES
+void SimdMath::log(const double* x, double* y, int n) {
+    for (int i = 0; i < n; ++i) y[i] = logKernel(x[i]);
+}
+
+SIMD_CLONES
+void SimdMath::normalCdf(const double* x, double* y, int n) {
+    for (int i = 0; i < n; ++i) y[i] = normalCdfKernel(x[i]);
+}
+
+// Inverse de N : approximation rationnelle d'Acklam (erreur relative 1.2e-9), raffine par un pas de Halley.
+// Par symtrie on rsout toujours dans la queue basse, N(x) = min(u, 1 - u), o normalCdfKernel est prcis
+// en relatif ; les branches centre / queue sont calcules puis slectionnes, comme dans normalCdfKernel.
+SIMD_CLONES
+void SimdMath::inverseNormalCdf(const double* u, double* z, int n) {
+    const double LOW = 0.02425;
+    // 1) Queue : -2 log(min(u, 1 - u))
+    for (int i = 0; i < n; ++i) {
+        double m = select(u[i] < 0.5, u[i], 1.0 - u[i]);
+        z[i] = -2.0 * logKernel(m);
+    }
+    // 2) Racine carre  part (errno), comme dans normals
+    for (int i = 0; i < n; ++i) z[i] = sqrt(z[i]);
+    // 3) Les deux approximations, slection, puis un pas de Halley
+    for (int i = 0; i < n; ++i) {
+        double p = u[i];
+        double m = select(p < 0.5, p, 1.0 - p);
+        double q = z[i];
+        double tail = (((((-7.784894002430293e-03 * q - 3.223964580411365e-01) * q - 2.400758277161838e+00) * q
+                       - 2.549732539343734e+00) * q + 4.374664141464968e+00) * q + 2.938163982698783e+00) /
+                      ((((7.784695709041462e-03 * q + 3.224671290700398e-01) * q + 2.445134137142996e+00) * q
+                       + 3.754408661907416e+00) * q + 1.0);
+        double c = m - 0.5, r = c * c;
+        double center = (((((-3.969683028665376e+01 * r + 2.209460984245205e+02) * r - 2.759285104469687e+02) * r
+                          + 1.383577518672690e+02) * r - 3.066479806614716e+01) * r + 2.506628277459239e+00) * c /
+                        (((((-5.447609879822406e+01 * r + 1.615858368580409e+02) * r - 1.556989798598866e+02) * r
+                          + 6.680131188771972e+01) * r - 1.328068155288572e+01) * r + 1.0);
+        double x = select(m < LOW, tail, center); // x <= 0
+        double e = normalCdfKernel(x) - m;
+        double h = e * 2.506628274631000502 * expKernel(0.5 * x * x);
+        x -= h / (1.0 + 0.5 * x * h);
+        z[i] = select(p < 0.5, x, -x);
+    }
+}
+
+SIMD_CLONES
+void SimdMath::normals(const uint32_t* bits, double* z, int n) {
+    int half = n / 2;
+    // 1) Rayon au carr : -2 log(u1), avec u1 dans ]0, 1[ (le log est toujours dfini)
+    for (int i = 0; i < half; ++i) {
+        double u1 = ((double)bits[i] + 0.5) * INV_2_32;
+        z[i] = -2.0 * logKernel(u1);
+    }
+    // 2) Racine carre : boucle  part, car sqrt (errno) empche la vectorisation du reste
+    for (int i = 0; i < half; ++i) z[i] = sqrt(z[i]);
+    // 3) Angle : 2*pi*u2, et les deux normales
+    for (int i = 0; i < half; ++i) {
+        double u2 = (double)bits[i + half] * INV_2_32;
+        double s, c;
+        sinCos2Pi(u2, s, c);
+        double radius = z[i];
+        z[i] = radius * c;
+        z[i + half] = radius * s;
+    }
+}
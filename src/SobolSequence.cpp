@@ -0,0 +1,148 @@
+#include "SobolSequence.h"
+#include "RandomStream.h"
+#include <mutex>
+#include <stdexcept>
+
+using namespace std;
+
+// Nombres directeurs initiaux m_1..m_s de Joe & Kuo (2008, fichier "new-joe-kuo-6.21201") pour les dimensions 2  21,
+// dans l'ordre des polynmes primitifs numrs ci-dessous (degr croissant puis coefficients croissants).
+static const int JOE_KUO_COUNT = 20;
+static const uint32_t JOE_KUO_M[JOE_KUO_COUNT][7] = {
+    {1}, {1, 3}, {1, 3, 1}, {1, 1, 1}, {1, 1, 3, 3}, {1, 3, 5, 13},
+    {1, 1, 5, 5, 17}, {1, 1, 5, 5, 5}, {1, 1, 7, 11, 19}, {1, 1, 5, 1, 1}, {1, 1, 1, 3, 11}, {1, 3, 5, 5, 31},
+    {1, 3, 3, 9, 7, 49}, {1, 1, 1, 15, 21, 21}, {1, 3, 1, 13, 27, 49}, {1, 1, 1, 15, 7, 5}, {1, 3, 1, 15, 13, 25}, {1, 1, 5, 5, 19, 61},
+    {1, 3, 7, 11, 23, 15, 103}, {1, 3, 7, 13, 13, 15, 69}
+};
+
+// Polynme sur GF(2) cod en bits : le bit i est le coefficient de x^i
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t poly, int degree) {
+    uint64_t result = 0;
+    while (b) {
+        if (b & 1) result ^= a;
+        b >>= 1;
+        a <<= 1;
+        if (a >> degree & 1) a ^= poly;
+    }
+    return result;
+}
+
+static uint64_t powMod(uint64_t exponent, uint64_t poly, int degree) { // x^exponent modulo poly
+    uint64_t result = 1, base = degree == 1 ? 1 : 2; // x = 1 modulo (x + 1)
+    while (exponent) {
+        if (exponent & 1) result = mulMod(result, base, poly, degree);
+        base = mulMod(base, base, poly, degree);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// Primitif <=> x est d'ordre exactement 2^degree - 1 modulo poly
+static bool isPrimitive(uint64_t poly, int degree) {
+    uint64_t order = (1ull << degree) - 1;
+    if (powMod(order, poly, degree) != 1) return false;
+    uint64_t n = order;
+    for (uint64_t q = 2; q * q <= n; ++q) {
+        if (n % q) continue;
+        if (powMod(order / q, poly, degree) == 1) return false;
+        while (n % q == 0) n /= q;
+    }
+    return n == 1 || n == order || powMod(order / n, poly, degree) != 1;
+}
+
+struct PrimitivePolynomial {
+    int degree;
+    uint32_t coefficients; // Coefficients intermdiaires a_1..a_{s-1} (a_1 = bit de poids fort)
+};
+
+// Les "count" premiers polynmes primitifs (calculs une fois, partags entre threads)
+static vector<PrimitivePolynomial> primitivePolynomials(int count) {
+    static mutex lock;
+    static vector<PrimitivePolynomial> table;
+    static int nextDegree = 1;
+    lock_guard<mutex> guard(lock);
+    while ((int)table.size() < count) {
+        int degree = nextDegree++;
+        if (degree > 31) throw runtime_error("SobolSequence : dimension trop grande");
+        for (uint32_t a = 0; a < (1u << (degree - 1)); ++a) {
+            uint64_t poly = (1ull << degree) | ((uint64_t)a << 1) | 1;
+            if (isPrimitive(poly, degree)) {
+                PrimitivePolynomial p = { degree, a };
+                table.push_back(p);
+            }
+        }
+    }
+    return vector<PrimitivePolynomial>(table.begin(), table.begin() + count);
+}
+
+SobolSequence::SobolSequence(int dim, uint64_t seed, uint64_t replica, bool scrambled)
+    : dimension(dim), directions(32 * dim), shift(dim, 0), state(dim, 0), index(0) {
+    vector<PrimitivePolynomial> polys = primitivePolynomials(dim > 1 ? dim - 1 : 0);
+    RandomStream initial(0x50B01ull, 0); // Flux fixe pour les nombres directeurs au-del de la table
+
+    for (int d = 0; d < dim; ++d) {
+        uint32_t* v = &directions[32 * d];
+        if (d == 0) { // Premire dimension : suite de van der Corput
+            for (int k = 0; k < 32; ++k) v[k] = 1u << (31 - k);
+            continue;
+        }
+        const PrimitivePolynomial& p = polys[d - 1];
+        int s = p.degree;
+        for (int k = 0; k < s && k < 32; ++k) {
+            uint32_t m = d - 1 < JOE_KUO_COUNT ? JOE_KUO_M[d - 1][k]
+                                               : ((initial() & ((1u << (k + 1)) - 1)) | 1u); // Impair et < 2^(k+1)
+            v[k] = m << (31 - k);
+        }
+        for (int k = s; k < 32; ++k) { // Rcurrence de Sobol'
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (int j = 1; j < s; ++j)
+                if ((p.coefficients >> (s - 1 - j)) & 1) v[k] ^= v[k - j];
+        }
+    }
+
+    if (scrambled) {
+        RandomStream gen(seed, (1ull << 63) | replica); // Flux distinct de ceux des blocs Monte Carlo
+        for (int d = 0; d < dim; ++d) {
+            // Matrice triangulaire infrieure  diagonale unit : le bit p de sortie dpend des bits >= p d'entre
+            uint32_t rows[32];
+            for (int p = 0; p < 32; ++p) {
+                uint32_t above = p == 31 ? 0u : ~((2u << p) - 1); // Bits de poids strictement suprieur  p
+                rows[p] = (1u << p) | (gen() & above);
+            }
+            uint32_t* v = &directions[32 * d];
+            for (int k = 0; k < 32; ++k) {
+                uint32_t scrambledV = 0;
+                for (int p = 0; p < 32; ++p) {
+                    uint32_t x = rows[p] & v[k];
+                    x ^= x >> 16; x ^= x >> 8; x ^= x >> 4; x ^= x >> 2; x ^= x >> 1; // Parit
+                    scrambledV |= (x & 1u) << p;
+                }
+                v[k] = scrambledV;
+            }
+            shift[d] = gen();
+        }
+    }
+}
+
+int SobolSequence::getDimension() const { return dimension; }
+
+void SobolSequence::skipTo(uint64_t i) {
+    index = i;
+    uint64_t gray = i ^ (i >> 1);
+    for (int d = 0; d < dimension; ++d) {
+        uint32_t x = 0;
+        for (int k = 0; k < 32; ++k)
+            if ((gray >> k) & 1) x ^= directions[32 * d + k];
+        state[d] = x;
+    }
+}
+
+void SobolSequence::next(double* u) {
+    for (int d = 0; d < dimension; ++d) u[d] = ((double)(state[d] ^ shift[d]) + 0.5) * (1.0 / 4294967296.0);
+
+    // Ordre de Gray : le point suivant ne diffre que par le nombre directeur du bit de poids faible qui change
+    ++index;
+    int c = 0;
+    while (((index >> c) & 1) == 0) ++c;
+    for (int d = 0; d < dimension; ++d) state[d] ^= directions[32 * d + c];
+}
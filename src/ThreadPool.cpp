@@ -0,0 +1,50 @@
+#include "ThreadPool.h"
+#include "Instrumentation.h"
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+int ThreadPool::hardwareThreads() {
+    unsigned int n = thread::hardware_concurrency();
+    return n == 0 ? 1 : (int)n;
+}
+
+void ThreadPool::run(int nbTasks, int nbThreads, const function<void(int)>& task) {
+    if (nbTasks <= 0) return;
+    if (nbThreads <= 0) nbThreads = hardwareThreads();
+    nbThreads = min(nbThreads, nbTasks);
+
+    atomic<int> next(0); // Prochaine tche  distribuer
+#ifndef PRICER_NO_INSTRUMENTATION
+    // Appel de pricing en cours : chaque thread y rapporte ses compteurs et son temps d'occupation, une fois  la fin
+    Instrumentation::Call* call = Instrumentation::Call::current();
+    auto worker = [&](int index) {
+        Instrumentation::Call::setCurrent(call);
+        Instrumentation::Counters before = Instrumentation::local();
+        long long start = Instrumentation::ticks();
+        int done = 0;
+        for (int i = next++; i < nbTasks; i = next++, ++done) task(i);
+        if (call) call->addWorker(index, before, Instrumentation::local(), Instrumentation::ticks() - start, done);
+        if (index > 0) Instrumentation::Call::setCurrent(nullptr);
+    };
+#else
+    auto worker = [&](int) {
+        for (int i = next++; i < nbTasks; i = next++) task(i);
+    };
+#endif
+
+    // Un seul thread : pas besoin de crer de threads
+    if (nbThreads == 1) {
+        worker(0);
+        return;
+    }
+
+    vector<thread> workers;
+    workers.reserve(nbThreads - 1);
+    for (int t = 1; t < nbThreads; ++t) workers.emplace_back(worker, t);
+    worker(0); // Le thread appelant travaille aussi
+    for (size_t t = 0; t < workers.size(); ++t) workers[t].join();
+}
@@ -0,0 +1,79 @@
+#include "TradeArena.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+TradeArena::TradeArena(size_t size): pageSize(max(size, (size_t)256)), current(0), offset(0), used(0) {}
+
+TradeArena::~TradeArena() {
+    reset();
+    for (size_t p = 0; p < pages.size(); ++p) ::operator delete(pages[p].data);
+}
+
+void* TradeArena::allocate(size_t size, size_t alignment) {
+    // Premire page ( partir de la courante) o l'objet tient, align ; sinon une nouvelle page
+    while (current < pages.size()) {
+        size_t start = (offset + alignment - 1) / alignment * alignment;
+        if (start + size <= pages[current].size) {
+            offset = start + size;
+            return pages[current].data + start;
+        }
+        used += offset;
+        ++current;
+        offset = 0;
+    }
+    Page page = { (char*)::operator new(max(pageSize, size)), max(pageSize, size) }; // Align pour tout type fondamental
+    pages.push_back(page);
+    offset = size;
+    return page.data;
+}
+
+template <class Concrete>
+Option* TradeArena::make(double T, double K) {
+    Option* option = new (allocate(sizeof(Concrete), alignof(Concrete))) Concrete(T, K);
+    options.push_back(option);
+    return option;
+}
+
+Option* TradeArena::createOption(Option::PayoffType type, double T, double K) {
+    switch (type) {
+    case Option::EUROPEAN_CALL:        return make<CallEuropeen>(T, K);
+    case Option::EUROPEAN_PUT:         return make<PutEuropeen>(T, K);
+    case Option::ASIAN_CALL:           return make<CallAsiatique>(T, K);
+    case Option::ASIAN_PUT:            return make<PutAsiatique>(T, K);
+    case Option::GEOMETRIC_ASIAN_CALL: return make<CallAsiatiqueGeometrique>(T, K);
+    case Option::GEOMETRIC_ASIAN_PUT:  return make<PutAsiatiqueGeometrique>(T, K);
+    case Option::DIGITAL_CALL:         return make<CallDigital>(T, K);
+    case Option::DIGITAL_PUT:          return make<PutDigital>(T, K);
+    case Option::LOOKBACK_CALL:        return make<CallLookback>(T, K);
+    case Option::LOOKBACK_PUT:         return make<PutLookback>(T, K);
+    default:                           return nullptr;
+    }
+}
+
+const char* TradeArena::copyString(const char* text, size_t length) {
+    char* copy = (char*)allocate(length + 1, 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void TradeArena::reset() {
+    for (size_t k = options.size(); k-- > 0;) options[k]->~Option();
+    options.clear();
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+size_t TradeArena::bytesUsed() const {
+    return used + offset;
+}
+
+size_t TradeArena::bytesReserved() const {
+    size_t total = 0;
+    for (size_t p = 0; p < pages.size(); ++p) total += pages[p].size;
+    return total;
+}
@@ -1,9 +1,18 @@
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include "BlackScholesModel.h"
 #include "Option.h"
 #include "MonteCarlo.h"
+#include "DistributedMonteCarlo.h"
+#include "PricingServer.h"
 #include "HedgingSimulator.h"
+#include "PdeSolver.h"
+#include "Pricer.h"
+#include "TradeArena.h"
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -20,24 +29,27 @@ double getIn(string txt) {
     return v;
 }
 
+// Familles du menu (1 Europenne, 2 Asiatique, 3 Digitale, 4 Lookback), version Call et version Put
+static const Option::PayoffType MENU_CALLS[] = { Option::EUROPEAN_CALL, Option::ASIAN_CALL, Option::DIGITAL_CALL, Option::LOOKBACK_CALL };
+static const Option::PayoffType MENU_PUTS[] = { Option::EUROPEAN_PUT, Option::ASIAN_PUT, Option::DIGITAL_PUT, Option::LOOKBACK_PUT };
+
 // Fonction d'affichage et de comparaison
-void afficherDetailsOption(Option* opt, BlackScholesModel& model, int N) { // Cette fonction prend un pointeur gnrique Option* (Polymorphisme)
+void afficherDetailsOption(const Option* opt, BlackScholesModel& model, int N) { // Cette fonction prend un pointeur gnrique Option* (Polymorphisme)
     cout << "\n--- Analyse : " << opt->getName() << " ---" << endl;
 
-    double priceMC = MonteCarlo::price(*opt, model, N);
-    double deltaMC = MonteCarlo::delta(*opt, model, N);
-    double gammaMC = MonteCarlo::gamma(*opt, model, N);
-    double vegaMC = MonteCarlo::vega(*opt, model, N);
+    // Une seule simulation pour le prix et les 3 Grecs (mmes tirages pour tous les chocs)
+    GreeksResult mc = MonteCarlo::priceWithGreeks(*opt, model, N);
 
-    cout << "Prix (Monte Carlo) : " << priceMC << endl;
-    cout << "Delta (Monte Carlo): " << deltaMC << endl;
-    cout << "Gamma (Monte Carlo): " << gammaMC << endl;
-    cout << "Vega (Monte Carlo) : " << vegaMC << endl;
+    cout << "Prix (Monte Carlo) : " << mc.price << " (+/- " << mc.priceStdError << ")" << endl;
+    cout << "Delta (Monte Carlo): " << mc.delta << " (+/- " << mc.deltaStdError << ")" << endl;
+    cout << "Gamma (Monte Carlo): " << mc.gamma << " (+/- " << mc.gammaStdError << ")" << endl;
+    cout << "Vega (Monte Carlo) : " << mc.vega << " (+/- " << mc.vegaStdError << ")" << endl;
+    if (Instrumentation::ENABLED) cout << "\n" << Instrumentation::lastProfile().summary();
 
     // Comparaison BS si c'est Europen
-    if (dynamic_cast<CallEuropeen*>(opt) || dynamic_cast<PutEuropeen*>(opt)) // Si (C'est un CallEuropeen) OU (C'est un PutEuropeen)
+    if (dynamic_cast<const CallEuropeen*>(opt) || dynamic_cast<const PutEuropeen*>(opt)) // Si (C'est un CallEuropeen) OU (C'est un PutEuropeen)
     {
-        bool isCall = (dynamic_cast<CallEuropeen*>(opt) != nullptr);
+        bool isCall = (dynamic_cast<const CallEuropeen*>(opt) != nullptr);
         double K = opt->getStrike();
         double T = opt->getMaturity();
 
@@ -47,10 +59,137 @@ void afficherDetailsOption(Option* opt, BlackScholesModel& model, int N) { // Ce
         cout << "Gamma BS : " << model.bsGamma(K, T) << endl;
         cout << "Vega BS  : " << model.bsVega(K, T) << endl;
     }
-    delete opt; // Nettoyage Mmoire
+
+    // Lookbacks : formule continue (Conze-Viswanathan) et sa correction aux dates de Monte Carlo (Broadie-Glasserman-Kou)
+    if (opt->closedForm() == Option::CORRECTED) {
+        bool isCall = (opt->payoffType() == Option::LOOKBACK_CALL);
+        int steps = MonteCarlo::stepsFor(opt->getMaturity());
+        cout << "\n[Formules fermees Lookback]" << endl;
+        cout << "Prix " << steps << " dates (BGK) : " << opt->closedFormPrice(model, steps) << endl;
+        cout << "Prix continu         : " << model.lookbackPrice(opt->getStrike(), opt->getMaturity(), isCall) << endl;
+    }
+    // Asiatiques arithmtiques : la moyenne gomtrique, en formule ferme, est une borne infrieure de la moyenne arithmtique
+    if (opt->payoffType() == Option::ASIAN_CALL || opt->payoffType() == Option::ASIAN_PUT) {
+        bool isCall = (opt->payoffType() == Option::ASIAN_CALL);
+        int steps = MonteCarlo::stepsFor(opt->getMaturity());
+        cout << "\n[Formule fermee Asiatique geometrique]" << endl;
+        cout << "Prix geometrique : " << model.geometricAsianPrice(opt->getStrike(), opt->getMaturity(), steps, isCall) << endl;
+    }
+
+    // Europennes et Digitales : Delta et Gamma lisses, lus sur la grille d'une EDP (Crank-Nicolson)
+    Option::PayoffType type = opt->payoffType();
+    if (type == Option::EUROPEAN_CALL || type == Option::EUROPEAN_PUT || type == Option::DIGITAL_CALL || type == Option::DIGITAL_PUT) {
+        PdeResult pde = PdeSolver::price(*opt, model);
+        cout << "\n[Differences finies Crank-Nicolson] (" << 1000 * pde.elapsedSeconds << " ms)" << endl;
+        cout << "Prix EDP  : " << pde.price << endl;
+        cout << "Delta EDP : " << pde.delta << endl;
+        cout << "Gamma EDP : " << pde.gamma << endl;
+    }
+}
+
+// Mode batch (production) : pricer --batch portefeuille.csv [--out resultats.csv] [--paths N] [--seed S] [--threads T]
+//                                    [--qmc] [--antithetic] [--control-variates] [--workers h:p,...] [--profile]
+// Mode worker (calcul rparti) : pricer --worker PORT [--threads T]
+// Mode service (clients concurrents) : pricer --serve SOCKET [--pool N] [--coalesce-us U] [--paths N] [--seed S] [--threads T] ...
+static int usage() {
+    cerr << "Usage : pricer --batch <portefeuille.csv | -> [--out <resultats.csv>] [--paths N] [--seed S] [--threads T]" << endl
+         << "                [--qmc] [--antithetic] [--control-variates] [--workers hote:port,...] [--profile]" << endl
+         << "        pricer --worker <port> [--threads T]" << endl
+         << "        pricer --serve <socket> [--pool N] [--coalesce-us U] [--paths N] [--seed S] [--threads T] [--antithetic] ..." << endl
+         << "--serve : service de valorisation sur une socket locale, une requete CSV par ligne (\"stats\" : latences p50/p99, debit)." << endl
+         << "--workers : simulations Monte Carlo reparties sur des processus \"pricer --worker\" (resultats identiques)." << endl
+         << "--profile : profil de chaque appel Monte Carlo (phases, trajectoires/s, threads) sur la sortie d'erreur." << endl
+         << "Sans argument : menu interactif." << endl;
+    return 2;
+}
+
+// Liste "hote:port,hote:port" de --workers
+static vector<string> splitWorkers(const string& list) {
+    vector<string> workers;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == string::npos) comma = list.size();
+        if (comma > start) workers.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return workers;
 }
 
-int main() {
+static int runBatchMode(int argc, char* argv[]) {
+    string input, output;
+    string socketPath;
+    int N = 100000, workerPort = 0, pool = 0, coalesceMicros = -1;
+    bool threadsGiven = false;
+    MonteCarloSettings settings(1); // Graine fixe par dfaut : deux lancements sur le mme portefeuille donnent les mmes prix
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--batch") && hasValue) input = argv[++i];
+        else if (!strcmp(argv[i], "--out") && hasValue) output = argv[++i];
+        else if (!strcmp(argv[i], "--paths") && hasValue) N = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && hasValue) settings.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--threads") && hasValue) { settings.nbThreads = atoi(argv[++i]); threadsGiven = true; }
+        else if (!strcmp(argv[i], "--qmc")) settings.generator = MonteCarloSettings::QUASI_RANDOM;
+        else if (!strcmp(argv[i], "--antithetic")) settings.antithetic = true;
+        else if (!strcmp(argv[i], "--control-variates")) settings.controlVariate = true;
+        else if (!strcmp(argv[i], "--workers") && hasValue) settings.workers = splitWorkers(argv[++i]);
+        else if (!strcmp(argv[i], "--worker") && hasValue) workerPort = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--serve") && hasValue) socketPath = argv[++i];
+        else if (!strcmp(argv[i], "--pool") && hasValue) pool = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--coalesce-us") && hasValue) coalesceMicros = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--profile")) Instrumentation::setObserver([](const PricingProfile& profile) { cerr << profile.summary(); });
+        else return usage();
+    }
+    if (workerPort > 0) {
+        cerr << "Worker Monte Carlo en ecoute sur le port " << workerPort << endl;
+        try {
+            DistributedMonteCarlo::serve(workerPort, settings.nbThreads);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+        }
+        return 1;
+    }
+    if (!socketPath.empty() && N > 0) {
+        PricingServerSettings serverSettings(socketPath);
+        serverSettings.nbWorkers = pool;
+        serverSettings.nbSimulations = N;
+        if (!threadsGiven) settings.nbThreads = 1; // Une simulation par worker du pool
+        serverSettings.monteCarlo = settings;
+        if (coalesceMicros >= 0) serverSettings.coalesceMicros = coalesceMicros;
+        PricingServer server(serverSettings);
+        cerr << "Service de valorisation sur " << socketPath << endl;
+        try {
+            server.run();
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (input.empty() || N <= 0) return usage();
+
+    ifstream file;
+    if (input != "-") {
+        file.open(input.c_str());
+        if (!file) { cerr << "Impossible d'ouvrir " << input << endl; return 1; }
+    }
+    ofstream result;
+    if (!output.empty()) {
+        result.open(output.c_str());
+        if (!result) { cerr << "Impossible de creer " << output << endl; return 1; }
+    }
+
+    try {
+        int rejected = Pricer::runBatch(input == "-" ? cin : file, output.empty() ? cout : result, cerr, N, settings);
+        return rejected > 0 ? 1 : 0; // Code de retour non nul si des lignes ont t rejetes
+    } catch (const exception& e) { // Rglages refuss par le moteur (par exemple --workers avec --qmc)
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) return runBatchMode(argc, argv);
 
     // Date et heure courantes
     std::time_t now = std::time(nullptr);
@@ -67,6 +206,7 @@ int main() {
 
     BlackScholesModel model(S0, r, sigma);
     int N = 50000; //Nombre de simulation que la mthode MonteCarlo va utiliser
+    TradeArena arena; // Options cres par le menu
 
     //----------------------------------------------MENU-------------------------------------------------------------
     // Le programme tourne tant que l'utilisateur ne choisit pas 0.
@@ -79,6 +219,8 @@ int main() {
         cout << "4. Lookback (Fixed Strike)" << endl;
         cout << "5. Simulation de Replication (Hedging)" << endl;
         cout << "6. Changer parametres de marche / Nb Simu" << endl;
+        cout << "7. Distribution du P&L de couverture (Monte Carlo)" << endl;
+        cout << "8. Grille de risque spot x volatilite (Monte Carlo)" << endl;
         cout << "0. Quitter" << endl;
         cout << "Choix : ";
         cin >> choix;
@@ -89,26 +231,11 @@ int main() {
             int type;
             cout << "1 pour CALL, 2 pour PUT : "; cin >> type;
 
-            Option* opt = nullptr; // Pointeur polymorphe
-
-            if (choix == 1) {
-                if(type == 1) opt = new CallEuropeen(T, K);
-                else opt = new PutEuropeen(T, K);
-            }
-            else if (choix == 2) {
-                if(type == 1) opt = new CallAsiatique(T, K);
-                else opt = new PutAsiatique(T, K);
-            }
-            else if (choix == 3) {
-                if(type == 1) opt = new CallDigital(T, K);
-                else opt = new PutDigital(T, K);
-            }
-            else if (choix == 4) {
-                if(type == 1) opt = new CallLookback(T, K);
-                else opt = new PutLookback(T, K);
-            }
+            // Pointeur polymorphe, cr dans l'arne du menu (libre d'un coup aprs l'analyse)
+            const Option* opt = arena.createOption(type == 1 ? MENU_CALLS[choix - 1] : MENU_PUTS[choix - 1], T, K);
 
             if(opt) afficherDetailsOption(opt, model, N); // Si l'objet a bien t cr, on lance l'analyse
+            arena.reset(); // Nettoyage Mmoire
         }
         else if (choix == 5) {
             double K = getIn("Strike (K): ");
@@ -117,6 +244,50 @@ int main() {
             // Appel de la mthode statique (pas besoin d'objet Option ici)
             HedgingSimulator::run(model, K, T, (type == 1));
         }
+        else if (choix == 7) {
+            double K = getIn("Strike (K): ");
+            double T = getIn("Maturite (T): ");
+            int type; cout << "1 pour CALL, 2 pour PUT : "; cin >> type;
+            int rebalances = (int)getIn("Nb de reajustements (ex: 50): ");
+            double cost = getIn("Cout de transaction (ex: 0.001): ");
+            HedgingSettings hedging(rebalances, cost);
+            HedgingResult pnl = HedgingSimulator::simulate(model, K, T, (type == 1), N, hedging);
+
+            cout << "\n--- P&L de couverture sur " << pnl.nbPaths << " trajectoires (" << pnl.elapsedSeconds << " s) ---" << endl;
+            cout << "Moyenne : " << pnl.mean << " (+/- " << pnl.stdError << ")" << endl;
+            cout << "Ecart-type : " << pnl.stdDev << endl;
+            cout << "Min / Max : " << pnl.minimum << " / " << pnl.maximum << endl;
+            for (size_t q = 0; q < pnl.quantiles.size(); ++q)
+                cout << "Quantile " << 100 * pnl.quantileLevels[q] << "% : " << pnl.quantiles[q] << endl;
+            if (Instrumentation::ENABLED) cout << "\n" << Instrumentation::lastProfile().summary();
+        }
+        else if (choix == 8) {
+            double K = getIn("Strike (K): ");
+            double T = getIn("Maturite (T): ");
+            int family; cout << "1 Europeenne, 2 Asiatique, 3 Digitale, 4 Lookback : "; cin >> family;
+            int type; cout << "1 pour CALL, 2 pour PUT : "; cin >> type;
+            if (family < 1 || family > 4) continue;
+            const Option* opt = arena.createOption(type == 1 ? MENU_CALLS[family - 1] : MENU_PUTS[family - 1], T, K);
+
+            // Chocs de spot -20 % .. +20 % (pas de 10 %), de volatilit -5, 0, +5 points : 15 cases, une simulation
+            vector<ScenarioShock> shocks;
+            for (int v = -1; v <= 1; v += 1)
+                for (int s = -2; s <= 2; ++s) {
+                    ScenarioShock shock = { 0.10 * s, 0.05 * v };
+                    shocks.push_back(shock);
+                }
+            try {
+                vector<ScenarioResult> grid = MonteCarlo::scenarioGrid(*opt, model, shocks, N, MonteCarloSettings());
+                cout << "\n--- Grille " << opt->getName() << " : prix / delta / gamma ---" << endl;
+                for (size_t k = 0; k < grid.size(); ++k)
+                    cout << "S=" << grid[k].spot << " vol=" << grid[k].volatility << " : " << grid[k].price << " / "
+                         << grid[k].delta << " / " << grid[k].gamma << endl;
+                if (Instrumentation::ENABLED) cout << "\n" << Instrumentation::lastProfile().summary();
+            } catch (const exception& e) {
+                cout << "Erreur : " << e.what() << endl;
+            }
+            arena.reset();
+        }
         else if (choix == 6) {
             S0 = getIn("Nouveau Spot: ");
             r = getIn("Nouveau Taux: ");
@@ -0,0 +1,60 @@
+// Mode batch sans allocation : une fois qu'un lot de mme taille a tourn dans le mme TradeBook, lire et valoriser
+// des contrats en formule ferme ne fait aucun appel  operator new (compteur d'allocations, li  ce test).
+// Code de sortie : 0 si le second lot n'alloue rien, 1 sinon.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Instrumentation.h"
+#include "Pricer.h"
+
+using namespace std;
+
+// Lecture directe d'une chane (istringstream recopierait le texte) et sortie jete (ostringstream grossirait)
+struct MemoryBuffer : public streambuf {
+    void reset(const string& text) { char* p = const_cast<char*>(text.data()); setg(p, p, p + text.size()); }
+};
+
+struct NullBuffer : public streambuf {
+    int overflow(int c) override { return c == EOF ? 0 : c; }
+};
+
+int main() {
+    if (!Instrumentation::allocationsCounted) {
+        cout << "ECHEC : compteur d'allocations absent (pricer_allocation_counter non lie)" << endl;
+        return 1;
+    }
+    // Toutes les familles  formule ferme, sur plusieurs strikes et maturits
+    const char* TYPES[] = { "CallEuropeen", "PutEuropeen", "CallAsiatiqueGeometrique", "PutAsiatiqueGeometrique",
+                            "CallLookback", "PutLookback" };
+    const int TRADES = 1024;
+    ostringstream csv;
+    csv << "id,type,strike,maturity,spot,rate,volatility\n";
+    for (int i = 0; i < TRADES; ++i)
+        csv << "trade-" << i << ',' << TYPES[i % 6] << ',' << 80 + i % 40 << ',' << 0.5 + (i % 4) * 0.5 << ",100,0.03,0.2\n";
+    string portfolio = csv.str();
+
+    MemoryBuffer input;
+    NullBuffer discard;
+    istream in(&input);
+    ostream out(&discard), errors(&discard);
+    TradeBook book;
+    MonteCarloSettings settings(1, 1);
+    long long allocations[2];
+    for (int run = 0; run < 2; ++run) { // Le premier lot dimensionne l'arne et le tableau des contrats
+        input.reset(portfolio);
+        in.clear();
+        long long before = Instrumentation::local().allocations;
+        int status = Pricer::runBatch(in, out, errors, 1000, settings, book);
+        allocations[run] = Instrumentation::local().allocations - before;
+        if (status != 0 || (int)book.trades.size() != TRADES) {
+            cout << "ECHEC : lot " << run << " refuse (code " << status << ", " << book.trades.size() << " contrats)" << endl;
+            return 1;
+        }
+    }
+    cout << "allocations : premier lot " << allocations[0] << ", second lot " << allocations[1] << endl;
+    if (allocations[1] != 0) {
+        cout << "ECHEC : le second lot de " << TRADES << " contrats alloue" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+// Heston : parit call-put du prix de Lewis, limite Black-Scholes quand la volatilit de la variance s'annule, et
+// Monte Carlo (schma QE)  4 erreurs standards de europeanPrice, avec une volatilit de la variance faible (branche
+// quadratique) et forte (la branche exponentielle prend le relais, psi > 1.5).
+// Code de sortie : 0 si tout passe, 1 sinon.
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "HestonModel.h"
+#include "MonteCarlo.h"
+
+using namespace std;
+
+static int failures = 0;
+
+static void expect(bool ok, const string& what) {
+    cout << (ok ? "ok    " : "ECHEC ") << what << endl;
+    if (!ok) ++failures;
+}
+
+int main() {
+    const double S0 = 100.0, r = 0.03;
+    const double STRIKES[] = { 80.0, 100.0, 120.0 };
+
+    // 1. Parit call-put et limite Black-Scholes (variance constante : v0 = theta, xi -> 0)
+    {
+        HestonModel heston(S0, r, 0.04, 1.5, 0.04, 0.5, -0.7);
+        HestonModel flat(S0, r, 0.04, 2.0, 0.04, 1e-4, -0.5);
+        BlackScholesModel model(S0, r, 0.2);
+        bool parity = true, limit = true;
+        for (double T : { 0.25, 1.0, 5.0 }) {
+            for (double K : STRIKES) {
+                double call = heston.europeanPrice(K, T, true), put = heston.europeanPrice(K, T, false);
+                parity = parity && call > 0.0 && put > 0.0 && fabs(call - put - (S0 - K * exp(-r * T))) < 1e-8;
+                limit = limit && fabs(flat.europeanPrice(K, T, true) - model.bsPrice(K, T, true)) < 1e-3;
+            }
+        }
+        expect(parity, "Lewis : parite call-put");
+        expect(limit, "Lewis : prix de Black-Scholes quand xi -> 0");
+    }
+
+    // 2. Schma QE face au prix semi-analytique
+    const double XI[] = { 0.3, 1.0 };
+    for (double xi : XI) {
+        HestonModel heston(S0, r, 0.04, 1.5, 0.04, xi, -0.7);
+        for (double K : { 100.0, 120.0 }) {
+            CallEuropeen call(1.0, K);
+            double reference = heston.europeanPrice(K, 1.0, true);
+            MonteCarloResult result = MonteCarlo::estimate(call, heston, 200000, MonteCarloSettings(3));
+            cout << "      QE, xi = " << xi << ", K = " << K << " : " << result.price << " +/- " << result.stdError
+                 << " (Lewis " << reference << ")" << endl;
+            expect(fabs(result.price - reference) < 4.0 * result.stdError,
+                   "QE : Call a 4 erreurs standards du prix de Lewis, xi = " + to_string(xi) + ", K = " + to_string(K));
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Volatilit implicite : aller-retour prix -> volatilit -> prix sur une chane (trs dans et hors de la monnaie,
+// maturits d'un jour  dix ans, volatilits de 5 %  150 %), par solve et par solveBatch ; NaN hors des bornes de
+// non-arbitrage et volatilit nulle pour un prix gal  la valeur intrinsque actualise.
+// Code de sortie : 0 si tout passe, 1 sinon.
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ImpliedVolatility.h"
+
+using namespace std;
+
+static int failures = 0;
+
+static void expect(bool ok, const string& what) {
+    cout << (ok ? "ok    " : "ECHEC ") << what << endl;
+    if (!ok) ++failures;
+}
+
+int main() {
+    const double S0 = 100.0, r = 0.03;
+    BlackScholesModel market(S0, r, 0.2); // Volatilit ignore par le solveur
+    const double STRIKES[] = { 40.0, 70.0, 90.0, 100.0, 110.0, 130.0, 200.0 };
+    const double MATURITIES[] = { 1.0 / 365.0, 0.05, 0.5, 2.0, 10.0 };
+    const double VOLS[] = { 0.05, 0.2, 0.6, 1.5 };
+
+    // 1. Aller-retour : le prix de la volatilit trouve redonne la cotation ; la volatilit est retrouve partout o
+    // le prix y est sensible (Vega non ngligeable devant la prcision du prix)
+    vector<double> prices, K, T, vols;
+    vector<char> calls;
+    for (double strike : STRIKES)
+        for (double maturity : MATURITIES)
+            for (double sigma : VOLS)
+                for (int call = 0; call < 2; ++call) {
+                    BlackScholesModel model(S0, r, sigma);
+                    double price = model.bsPrice(strike, maturity, call != 0);
+                    double intrinsic = call ? max(S0 - strike * exp(-r * maturity), 0.0) : max(strike * exp(-r * maturity) - S0, 0.0);
+                    if (price - intrinsic < 1e-10 * S0) continue; // Valeur temps sous la prcision des doubles
+                    prices.push_back(price);
+                    K.push_back(strike);
+                    T.push_back(maturity);
+                    vols.push_back(sigma);
+                    calls.push_back(call != 0);
+                }
+    int n = prices.size();
+    vector<double> batch(n);
+    unique_ptr<bool[]> isCall(new bool[n]); // vector<bool> n'a pas de data()
+    for (int i = 0; i < n; ++i) isCall[i] = calls[i] != 0;
+    ImpliedVolatility::solveBatch(market, prices.data(), K.data(), T.data(), isCall.get(), n, batch.data());
+    int priceMisses = 0, volMisses = 0, batchMisses = 0;
+    for (int i = 0; i < n; ++i) {
+        double vol = ImpliedVolatility::solve(market, prices[i], K[i], T[i], isCall[i]);
+        BlackScholesModel model(S0, r, vol);
+        double repriced = model.bsPrice(K[i], T[i], isCall[i]);
+        if (!(fabs(repriced - prices[i]) < 1e-9 * max(1.0, prices[i]))) ++priceMisses;
+        if (model.bsVega(K[i], T[i]) > 1e-4 && !(fabs(vol - vols[i]) < 1e-6)) ++volMisses;
+        if (!(fabs(batch[i] - vol) < 1e-8)) ++batchMisses;
+    }
+    cout << "      " << n << " cotations" << endl;
+    expect(priceMisses == 0, "solve : prix retrouve (" + to_string(priceMisses) + " ecarts)");
+    expect(volMisses == 0, "solve : volatilite retrouvee (" + to_string(volMisses) + " ecarts)");
+    expect(batchMisses == 0, "solveBatch : memes volatilites que solve (" + to_string(batchMisses) + " ecarts)");
+
+    // 2. Bornes de non-arbitrage : NaN en dehors, 0 sur la valeur intrinsque actualise
+    double T1 = 1.0, discountedK = 90.0 * exp(-r * T1);
+    const double OUTSIDE[][3] = { // prix, strike, call (1) ou put (0)
+        { S0 - discountedK - 0.01, 90.0, 1 }, // Call sous S - K e^{-rT}
+        { S0, 90.0, 1 },                      // Call au prix du sous-jacent
+        { -0.5, 110.0, 1 },                   // Prix ngatif
+        { 110.0 * exp(-r * T1), 110.0, 0 },   // Put au strike actualis
+        { 110.0 * exp(-r * T1) - S0 - 0.01, 110.0, 0 } // Put sous K e^{-rT} - S
+    };
+    bool nans = true;
+    for (size_t i = 0; i < sizeof(OUTSIDE) / sizeof(OUTSIDE[0]); ++i) {
+        bool call = OUTSIDE[i][2] != 0.0;
+        double vol = ImpliedVolatility::solve(market, OUTSIDE[i][0], OUTSIDE[i][1], T1, call), batchVol;
+        ImpliedVolatility::solveBatch(market, &OUTSIDE[i][0], &OUTSIDE[i][1], &T1, &call, 1, &batchVol);
+        nans = nans && std::isnan(vol) && std::isnan(batchVol);
+    }
+    nans = nans && std::isnan(ImpliedVolatility::solve(market, 5.0, 100.0, 0.0, true)); // Maturit nulle
+    expect(nans, "hors des bornes de non-arbitrage : NaN");
+
+    bool call = true;
+    double intrinsic = S0 - discountedK, batchVol;
+    ImpliedVolatility::solveBatch(market, &intrinsic, &OUTSIDE[0][1], &T1, &call, 1, &batchVol);
+    expect(ImpliedVolatility::solve(market, intrinsic, 90.0, T1, true) == 0.0 && batchVol == 0.0,
+           "prix egal a la valeur intrinseque actualisee : volatilite nulle");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+// Classe drive d'une option prdfinie qui ne redfinit que payoff(path) : Monte Carlo doit appeler ce payoff, et
+// non le noyau compil, le payoff streaming, la formule ferme ou la variable de contrle hrits.
+// Code de sortie : 0 si le prix est celui du payoff redfini, 1 sinon.
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "MonteCarlo.h"
+
+using namespace std;
+
+// Deux fois le payoff du Call Europen
+class DoubleCall : public CallEuropeen {
+public:
+    DoubleCall(double T, double K): CallEuropeen(T, K) {}
+    double payoff(const vector<double>& path) const override { return 2.0 * CallEuropeen::payoff(path); }
+};
+
+int main() {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    DoubleCall option(1.0, 100.0);
+    int failures = 0;
+    if (option.payoffType() != Option::CUSTOM || option.isStreamable() || option.closedForm() != Option::NO_CLOSED_FORM
+        || option.hasControlVariate()) {
+        cout << "ECHEC : la classe derivee herite du traitement de CallEuropeen" << endl;
+        ++failures;
+    }
+
+    double reference = 2.0 * model.bsPrice(100.0, 1.0, true);
+    MonteCarloSettings settings(7, 1);
+    settings.controlVariate = true; // Ignor : la variable de contrle hrite ne s'applique pas  ce payoff
+    MonteCarloResult result = MonteCarlo::estimate(option, model, 100000, settings);
+    cout << "classe derivee : " << result.price << " +/- " << result.stdError << ", attendu " << reference << endl;
+    if (fabs(result.price - reference) > 4.0 * result.stdError) {
+        cout << "ECHEC : prix Monte Carlo loin de deux fois le Call" << endl;
+        ++failures;
+    }
+
+    vector<const Option*> group(1, &option);
+    MonteCarloResult grouped = MonteCarlo::estimateMany(group, model, 100000, settings)[0];
+    if (fabs(grouped.price - reference) > 4.0 * grouped.stdError) {
+        cout << "ECHEC : estimateMany loin de deux fois le Call (" << grouped.price << ")" << endl;
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
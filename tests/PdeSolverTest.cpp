@@ -0,0 +1,62 @@
+// Diffrences finies face aux formules exactes : prix, Delta et Gamma des Europennes (bsPrice, bsDelta, bsGamma) et
+// des Digitales (e^{-rT} N(+/- d2)),  maturits courte et longue, dans et hors de la monnaie, et chelle de strikes.
+// Une rgression de la grille en sinh, des pas de Rannacher ou du solveur tridiagonal dpasse ces tolrances.
+// Code de sortie : 0 si tout passe, 1 sinon.
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PdeSolver.h"
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(const string& label, double value, double reference, double tolerance) {
+    if (fabs(value - reference) < tolerance) return;
+    cout << "ECHEC " << label << " : " << value << " au lieu de " << reference << " (tolerance " << tolerance << ")" << endl;
+    ++failures;
+}
+
+int main() {
+    const double S0 = 100.0, r = 0.05, sigma = 0.2;
+    BlackScholesModel model(S0, r, sigma);
+    const double MATURITIES[] = { 0.1, 1.0, 3.0 }, STRIKES[] = { 70.0, 100.0, 130.0 };
+    int count = 0;
+    for (double T : MATURITIES) {
+        for (double K : STRIKES) {
+            string label = "T = " + to_string(T) + ", K = " + to_string(K);
+            CallEuropeen call(T, K);
+            PutEuropeen put(T, K);
+            CallDigital digitalCall(T, K);
+            PutDigital digitalPut(T, K);
+            PdeResult c = PdeSolver::price(call, model), p = PdeSolver::price(put, model);
+            PdeResult dc = PdeSolver::price(digitalCall, model), dp = PdeSolver::price(digitalPut, model);
+            check(label + ", prix du Call", c.price, model.bsPrice(K, T, true), 1e-3);
+            check(label + ", prix du Put", p.price, model.bsPrice(K, T, false), 1e-3);
+            check(label + ", Delta du Call", c.delta, model.bsDelta(K, T, true), 1e-4);
+            check(label + ", Delta du Put", p.delta, model.bsDelta(K, T, false), 1e-4);
+            check(label + ", Gamma du Call", c.gamma, model.bsGamma(K, T), 1e-5);
+
+            double sqrtT = sqrt(T), d2 = (log(S0 / K) + (r - 0.5 * sigma * sigma) * T) / (sigma * sqrtT);
+            double discount = exp(-r * T), nd2 = 0.5 * erfc(-d2 / sqrt(2.0));
+            double digitalDelta = discount * exp(-0.5 * d2 * d2) / (sqrt(2.0 * M_PI) * S0 * sigma * sqrtT);
+            check(label + ", prix de la Digitale Call", dc.price, discount * nd2, 1e-4);
+            check(label + ", prix de la Digitale Put", dp.price, discount * (1.0 - nd2), 1e-4);
+            check(label + ", Delta de la Digitale Call", dc.delta, digitalDelta, 1e-5);
+            count += 9;
+        }
+        // chelle de strikes : une seule rsolution pour tous
+        vector<double> strikes(STRIKES, STRIKES + 3);
+        vector<PdeResult> ladder = PdeSolver::priceLadder(Option::EUROPEAN_CALL, strikes, T, model);
+        for (size_t k = 0; k < strikes.size(); ++k)
+            check("echelle, T = " + to_string(T) + ", K = " + to_string(strikes[k]), ladder[k].price,
+                  model.bsPrice(strikes[k], T, true), 1e-3);
+        count += strikes.size();
+    }
+    cout << count - failures << " / " << count << " valeurs aux tolerances des formules exactes" << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// Quasi-Monte Carlo : nombres directeurs de Joe & Kuo (suite non brouille), structure de (t, s)-suite conserve par le
+// brouillage de chaque rplication, covariance exacte du pont brownien, et Call europen en QUASI_RANDOM face 
+// Black-Scholes, avec une erreur standard tire des rplications.
+// Code de sortie : 0 si tout passe, 1 sinon.
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "BrownianBridge.h"
+#include "MonteCarlo.h"
+#include "SobolSequence.h"
+
+using namespace std;
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what) {
+    cout << (ok ? "ok    " : "ECHEC ") << what << endl;
+    if (!ok) ++failures;
+}
+
+// Point 2^(k+1) - 1 (ordre de Gray) = nombre directeur v_k de chaque dimension, soit m_{k+1} / 2^(k+1) :
+// 128 * point pour k = 6, dimensions 1  21 (new-joe-kuo-6.21201, rcurrence comprise)
+static const int JOE_KUO_M7[21] = { 1, 85, 71, 81, 61, 43, 31, 9, 53, 69, 79, 75, 113, 33, 77, 35, 123, 27, 87, 103, 69 };
+
+int main() {
+    // 1. Suite non brouille : premiers points et nombres directeurs
+    {
+        SobolSequence sobol(21, 0, 0, false);
+        vector<double> u(21);
+        const double FIRST[8][5] = { { 0, 0, 0, 0, 0 }, { .5, .5, .5, .5, .5 }, { .75, .25, .25, .25, .75 },
+                                     { .25, .75, .75, .75, .25 }, { .375, .375, .625, .875, .375 },
+                                     { .875, .875, .125, .375, .875 }, { .625, .125, .875, .625, .625 },
+                                     { .125, .625, .375, .125, .125 } };
+        bool same = true;
+        for (int i = 0; i < 8; ++i) {
+            sobol.next(u.data());
+            for (int d = 0; d < 5; ++d) same = same && fabs(u[d] - FIRST[i][d]) < 1e-9;
+        }
+        sobol.skipTo(127);
+        sobol.next(u.data());
+        for (int d = 0; d < 21; ++d) same = same && (int)(u[d] * 128) == JOE_KUO_M7[d];
+        expect(same, "Sobol' non brouille : premiers points et nombres directeurs de Joe & Kuo");
+    }
+
+    // 2. Chaque rplication brouille reste une (t, s)-suite : les 2^m premiers points ont exactement un point par
+    // intervalle lmentaire de volume 2^-m, sur chaque dimension et sur les deux premires ((0, 2)-suite)
+    {
+        const int M = 10, N = 1 << M, DIM = 21;
+        bool nets = true;
+        for (int replica = 0; replica < 4; ++replica) {
+            SobolSequence sobol(DIM, 42, replica);
+            vector<double> points((size_t)N * DIM);
+            for (int i = 0; i < N; ++i) sobol.next(&points[(size_t)i * DIM]);
+            for (int d = 0; d < DIM; ++d) {
+                vector<int> cells(N, 0);
+                for (int i = 0; i < N; ++i) ++cells[(int)(points[(size_t)i * DIM + d] * N)];
+                for (int c = 0; c < N; ++c) nets = nets && cells[c] == 1;
+            }
+            for (int a = 0; a <= M; ++a) {
+                vector<int> cells(N, 0);
+                for (int i = 0; i < N; ++i) {
+                    int x = (int)(points[(size_t)i * DIM] * (1 << a)), y = (int)(points[(size_t)i * DIM + 1] * (1 << (M - a)));
+                    ++cells[(x << (M - a)) | y];
+                }
+                for (int c = 0; c < N; ++c) nets = nets && cells[c] == 1;
+            }
+        }
+        expect(nets, "Sobol' brouille : un point par intervalle elementaire, pour chaque replication");
+    }
+
+    // 3. Pont brownien (7 pas, pas une puissance de 2) : linaire en z, accroissements indpendants de variance dt
+    {
+        const int STEPS = 7;
+        const double T = 1.5, dt = T / STEPS;
+        BrownianBridge bridge(STEPS, T);
+        vector<double> z(STEPS), dW(STEPS), covariance(STEPS * STEPS, 0.0);
+        for (int j = 0; j < STEPS; ++j) { // Colonne j : rponse  la normale z_j
+            fill(z.begin(), z.end(), 0.0);
+            z[j] = 1.0;
+            bridge.build(z.data(), dW.data(), 1);
+            for (int i = 0; i < STEPS; ++i)
+                for (int k = 0; k < STEPS; ++k) covariance[i * STEPS + k] += dW[i] * dW[k];
+        }
+        bool exact = true;
+        for (int i = 0; i < STEPS; ++i)
+            for (int k = 0; k < STEPS; ++k) exact = exact && fabs(covariance[i * STEPS + k] - (i == k ? dt : 0.0)) < 1e-12;
+        fill(z.begin(), z.end(), 0.0);
+        z[0] = 1.0; // La premire normale fixe W(T)
+        bridge.build(z.data(), dW.data(), 1);
+        double end = 0.0;
+        for (int i = 0; i < STEPS; ++i) end += dW[i];
+        expect(exact && fabs(end - sqrt(T)) < 1e-12, "pont brownien : covariance des accroissements et W(T)");
+    }
+
+    // 4. Call europen en QUASI_RANDOM : prix  4 erreurs standards de Black-Scholes ;  points par rplication
+    // fixs, 16 fois plus de rplications divisent l'erreur standard par environ 4 (plus de 2 avec 16 rplications)
+    {
+        BlackScholesModel model(100.0, 0.05, 0.2);
+        CallEuropeen call(1.0, 105.0);
+        double reference = model.bsPrice(105.0, 1.0, true);
+        const int POINTS = 1024;
+        MonteCarloResult results[2];
+        const int REPLICAS[2] = { 16, 256 };
+        for (int i = 0; i < 2; ++i) {
+            MonteCarloSettings settings(5);
+            settings.generator = MonteCarloSettings::QUASI_RANDOM;
+            settings.nbReplicas = REPLICAS[i];
+            results[i] = MonteCarlo::estimate(call, model, REPLICAS[i] * POINTS, settings);
+            cout << "      QMC, " << REPLICAS[i] << " replications : " << results[i].price << " +/- " << results[i].stdError
+                 << " (Black-Scholes " << reference << ")" << endl;
+        }
+        expect(results[1].nbPaths == 256 * POINTS && fabs(results[1].price - reference) < 4.0 * results[1].stdError,
+               "QMC : Call europeen a 4 erreurs standards de Black-Scholes");
+        expect(results[0].stdError > 0.0 && results[1].stdError < results[0].stdError / 2.0,
+               "QMC : l'erreur standard decroit avec le nombre de replications");
+    }
+    return failures == 0 ? 0 : 1;
+}
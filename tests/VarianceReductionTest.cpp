@@ -0,0 +1,68 @@
+// Rduction de variance : chaque estimateur (antithtique, variable de contrle, moment matching, les trois ensemble)
+// reste sans biais,  4 erreurs standards prs, face  une formule ferme (Black-Scholes, asiatique gomtrique,
+// digitale) ou, sans formule, face  un long run sans rduction ; et son facteur de rduction de variance dpasse 1.
+// Code de sortie : 0 si tout passe, 1 sinon.
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "MonteCarlo.h"
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(const string& label, const MonteCarloResult& result, double reference, double referenceError, bool reduced) {
+    double tolerance = 4.0 * sqrt(result.stdError * result.stdError + referenceError * referenceError);
+    bool ok = fabs(result.price - reference) < tolerance && (!reduced || result.varianceReduction > 1.0);
+    cout << (ok ? "ok    " : "ECHEC ") << label << " : " << result.price << " +/- " << result.stdError << " (reference "
+         << reference << "), VRF " << result.varianceReduction << endl;
+    if (!ok) ++failures;
+}
+
+// Digitale : e^{-rT} N(+/- d2)
+static double digitalPrice(double S0, double r, double sigma, double K, double T, bool isCall) {
+    double d2 = (log(S0 / K) + (r - 0.5 * sigma * sigma) * T) / (sigma * sqrt(T));
+    return exp(-r * T) * 0.5 * erfc((isCall ? -d2 : d2) / sqrt(2.0));
+}
+
+int main() {
+    const double S0 = 100.0, r = 0.05, sigma = 0.2, K = 100.0, T = 0.5;
+    const int PATHS = 100000;
+    BlackScholesModel model(S0, r, sigma);
+    int steps = MonteCarlo::stepsFor(T);
+
+    CallEuropeen call(T, K);
+    PutEuropeen put(T, K);
+    CallAsiatiqueGeometrique geometric(T, K);
+    CallDigital digitalCall(T, K);
+    PutDigital digitalPut(T, K);
+    CallAsiatique asian(T, K);
+    CallLookback lookback(T, K);
+    struct Case { const Option* option; double reference; };
+    Case cases[] = { { &call, model.bsPrice(K, T, true) }, { &put, model.bsPrice(K, T, false) },
+                     { &geometric, model.geometricAsianPrice(K, T, steps, true) },
+                     { &digitalCall, digitalPrice(S0, r, sigma, K, T, true) },
+                     { &digitalPut, digitalPrice(S0, r, sigma, K, T, false) },
+                     { &asian, NAN }, { &lookback, NAN } };
+
+    const char* NAMES[] = { "simple", "antithetique", "controle", "moment matching", "les trois" };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        const Option& option = *cases[c].option;
+        double reference = cases[c].reference, referenceError = 0.0;
+        if (std::isnan(reference)) { // Sans formule ferme : long run simple, graine distincte
+            MonteCarloResult longRun = MonteCarlo::estimate(option, model, 20 * PATHS, MonteCarloSettings(1000 + c));
+            reference = longRun.price;
+            referenceError = longRun.stdError;
+        }
+        for (int e = 0; e < 5; ++e) {
+            if ((e == 2 || e == 4) && !option.hasControlVariate()) continue;
+            MonteCarloSettings settings(17);
+            settings.antithetic = (e == 1 || e == 4);
+            settings.controlVariate = (e == 2 || e == 4);
+            settings.momentMatching = (e == 3 || e == 4);
+            MonteCarloResult result = MonteCarlo::estimate(option, model, PATHS, settings);
+            check(string(option.getName()) + ", " + NAMES[e], result, reference, referenceError, e != 0);
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
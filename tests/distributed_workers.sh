@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Calcul réparti de bout en bout sur une machine : pricer --batch avec --workers doit donner, au bit près, la sortie
+# d'un run local, avec deux workers, un worker tué pendant le run, une adresse sans worker et (si python3 est là) un
+# worker qui accepte la connexion sans jamais répondre.
+# Usage : distributed_workers.sh <chemin de pricer>
+set -u
+PRICER=${1:?usage: distributed_workers.sh <pricer>}
+WORK=$(mktemp -d)
+BASE=$((20000 + ($$ % 2000) * 8)) # Ports propres à ce run : plusieurs ctest en parallèle ne se gênent pas
+PIDS=()
+cleanup() {
+    for pid in "${PIDS[@]}"; do kill "$pid" 2>/dev/null; done
+    wait 2>/dev/null
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+fail() { echo "ECHEC : $*" >&2; exit 1; }
+
+start_worker() { # port
+    "$PRICER" --worker "$1" --threads 1 2>/dev/null &
+    PIDS+=($!)
+    for _ in $(seq 50); do
+        (exec 3<>"/dev/tcp/127.0.0.1/$1") 2>/dev/null && return 0
+        sleep 0.1
+    done
+    fail "le worker du port $1 ne repond pas"
+}
+
+# Deux groupes Monte Carlo (maturités différentes), payoffs sans formule fermée
+cat > "$WORK/book.csv" <<EOF
+a,CallAsiatique,100,1,100,0.05,0.2
+b,PutDigital,95,1,100,0.05,0.2
+c,CallAsiatique,110,2,100,0.03,0.3
+d,PutAsiatique,90,2,100,0.03,0.3
+EOF
+
+run_batch() { # sortie paths [--workers liste]
+    local out=$1 paths=$2
+    shift 2
+    timeout 120 "$PRICER" --batch "$WORK/book.csv" --paths "$paths" --seed 11 --threads 1 "$@" > "$out" ||
+        fail "pricer --batch $* (code $?)"
+}
+
+run_batch "$WORK/local.csv" 200000
+
+# 1. Deux workers
+start_worker $((BASE + 1))
+start_worker $((BASE + 2))
+run_batch "$WORK/two.csv" 200000 --workers 127.0.0.1:$((BASE + 1)),127.0.0.1:$((BASE + 2))
+cmp -s "$WORK/local.csv" "$WORK/two.csv" || fail "deux workers : sortie differente du run local"
+
+# 2. Adresse sans worker à côté d'un worker vivant
+run_batch "$WORK/unreachable.csv" 200000 --workers 127.0.0.1:$((BASE + 3)),127.0.0.1:$((BASE + 1))
+cmp -s "$WORK/local.csv" "$WORK/unreachable.csv" || fail "adresse injoignable : sortie differente du run local"
+
+# 3. Worker tué pendant le run (assez de trajectoires pour qu'il soit en cours de tranche)
+run_batch "$WORK/local_big.csv" 2000000
+start_worker $((BASE + 4))
+VICTIM=${PIDS[-1]}
+(sleep 0.5; kill -9 "$VICTIM" 2>/dev/null) &
+run_batch "$WORK/killed.csv" 2000000 --workers 127.0.0.1:$((BASE + 4)),127.0.0.1:$((BASE + 2))
+cmp -s "$WORK/local_big.csv" "$WORK/killed.csv" || fail "worker tue : sortie differente du run local"
+
+# 4. Worker muet : la connexion est acceptée, aucune réponse (délai d'attente puis reprise par l'autre worker)
+if command -v python3 > /dev/null; then
+    python3 -c '
+import socket, sys, time
+s = socket.socket(); s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(("127.0.0.1", int(sys.argv[1]))); s.listen(8)
+kept = []
+while True: kept.append(s.accept()[0])
+' $((BASE + 5)) &
+    PIDS+=($!)
+    sleep 0.5
+    run_batch "$WORK/silent.csv" 200000 --workers 127.0.0.1:$((BASE + 5)),127.0.0.1:$((BASE + 1))
+    cmp -s "$WORK/local.csv" "$WORK/silent.csv" || fail "worker muet : sortie differente du run local"
+fi
+
+echo "calcul reparti : sorties identiques au run local"